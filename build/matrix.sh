@@ -0,0 +1,165 @@
+#!/bin/sh
+# Builds the harness with every compiler and flag set of a matrix (CMake
+# variant "custom"), runs each build, and merges the results into one CSV with
+# Compiler and Flags columns. A table of per-implementation speedups over the
+# first compiler and flag set is printed and written next to it.
+#
+# Usage: matrix.sh [-c compiler]... [-f flags]... [-t type] [-o outdir]
+#   -c  C++ compiler. The C compiler is derived from it (g++-13 -> gcc-13,
+#       clang++ -> clang) or given as cc:cxx. Default: g++ and clang++, where
+#       found.
+#   -f  Flag set for C and C++. Default: "-O2 -msse4.2" (the project's flags)
+#       and "-O3 -march=native". Pass the production flags here.
+#   -t  Result type the speedup table is computed from. Default: randomdigit.
+#   -o  Output directory. Default: build/matrix.
+#
+# Example: build/matrix.sh -c g++-12 -c clang++-15 -f "-O2" -f "-O3 -flto"
+
+root=$(cd "$(dirname "$0")/.." && pwd)
+compilers=
+flagsets=
+type=randomdigit
+out="$root/build/matrix"
+
+nl='
+'
+while getopts "c:f:t:o:" opt; do
+	case $opt in
+	c) compilers="$compilers$OPTARG$nl" ;;
+	f) flagsets="$flagsets$OPTARG$nl" ;;
+	t) type=$OPTARG ;;
+	o) out=$OPTARG ;;
+	*) sed -n '2,17s/^# \{0,1\}//p' "$0"; exit 1 ;;
+	esac
+done
+
+if [ -z "$compilers" ]; then
+	for cxx in g++ clang++; do
+		command -v $cxx >/dev/null 2>&1 && compilers="$compilers$cxx$nl"
+	done
+fi
+[ -n "$flagsets" ] || flagsets="-O2 -msse4.2$nl-O3 -march=native$nl"
+
+mkdir -p "$out" || exit 1
+out=$(cd "$out" && pwd)
+for dir in "$out"/[0-9]*; do
+	[ -f "$dir/config" ] && rm -rf "$dir"
+done
+
+# Each build runs two directories below $out/<n>, where the harness finds no
+# result/template.php, so its CSV stays in the run directory.
+n=0
+IFS=$nl
+for compiler in $compilers; do
+	case $compiler in
+	*:*) cc=${compiler%%:*}; cxx=${compiler#*:} ;;
+	*clang++*) cxx=$compiler; cc=$(echo "$compiler" | sed 's/clang++/clang/') ;;
+	*g++*) cxx=$compiler; cc=$(echo "$compiler" | sed 's/g++/gcc/') ;;
+	*) cxx=$compiler; cc=cc ;;
+	esac
+	if ! command -v "$cxx" >/dev/null 2>&1; then
+		echo "Skipping $cxx: not found"
+		continue
+	fi
+	name="$cxx $("$cxx" -dumpversion)"
+
+	for flags in $flagsets; do
+		n=$((n + 1))
+		dir="$out/$(printf %02d $n)"
+		mkdir -p "$dir/run/run"
+		printf '%s\n%s\n' "$name" "$flags" > "$dir/config"
+
+		echo "[$n] $name $flags"
+		if ! cmake -S "$root" -B "$dir/build" \
+				-DCMAKE_C_COMPILER="$cc" -DCMAKE_CXX_COMPILER="$cxx" \
+				-DDTOA_VARIANT=custom \
+				-DCMAKE_C_FLAGS="$flags" -DCMAKE_CXX_FLAGS="$flags" \
+				> "$dir/build.log" 2>&1 ||
+			! cmake --build "$dir/build" -j "$(nproc 2>/dev/null || echo 1)" \
+				>> "$dir/build.log" 2>&1; then
+			echo "    build failed, see $dir/build.log"
+			continue
+		fi
+
+		(cd "$dir/run/run" && "$dir/build/dtoa" > "$dir/run.log" 2>&1)
+		set -- "$dir"/run/run/*.csv
+		if [ ! -f "$1" ]; then
+			echo "    no results, see $dir/run.log"
+			continue
+		fi
+		cp "$1" "$dir/result.csv"
+	done
+done
+unset IFS
+
+set -- "$out"/[0-9]*/result.csv
+if [ ! -f "$1" ]; then
+	echo "No results"
+	exit 1
+fi
+
+# Merged CSV: Compiler and Flags are quoted, as flags may contain commas.
+awk '
+	FNR == 1 {
+		getline compiler < (substr(FILENAME, 1, length(FILENAME) - 10) "config")
+		getline flags < (substr(FILENAME, 1, length(FILENAME) - 10) "config")
+		gsub(/"/, "\"\"", compiler)
+		gsub(/"/, "\"\"", flags)
+		if (NR == 1)
+			print "Compiler,Flags," $0
+		next
+	}
+	{ print "\"" compiler "\",\"" flags "\"," $0 }
+' "$@" > "$out/matrix.csv"
+
+# Speedup table: average Time(ns) of each function over the digits of the
+# chosen type, per build, with the speedup over the first build.
+awk -F, -v type="$type" '
+	FNR == 1 {
+		config = substr(FILENAME, 1, length(FILENAME) - 10) "config"
+		getline compiler < config
+		getline flags < config
+		builds++
+		label[builds] = compiler " " flags
+		next
+	}
+	$1 == type {
+		if (!(($2) in seen)) {
+			seen[$2] = 1
+			functions[++nfunctions] = $2
+		}
+		sum[builds, $2] += $4
+		count[builds, $2]++
+	}
+	END {
+		printf "| Function |"
+		for (b = 1; b <= builds; b++)
+			printf " %s |", label[b]
+		printf "\n|---|"
+		for (b = 1; b <= builds; b++)
+			printf "---|"
+		printf "\n"
+		for (i = 1; i <= nfunctions; i++) {
+			f = functions[i]
+			printf "| %s |", f
+			base = count[1, f] ? sum[1, f] / count[1, f] : 0
+			for (b = 1; b <= builds; b++) {
+				if (!count[b, f]) {
+					printf " - |"
+					continue
+				}
+				t = sum[b, f] / count[b, f]
+				if (b == 1 || !base)
+					printf " %.3fns |", t
+				else
+					printf " %.3fns (%.2fx) |", t, base / t
+			}
+			printf "\n"
+		}
+	}
+' "$@" > "$out/speedup.md"
+
+cat "$out/speedup.md"
+echo
+echo "Merged results: $out/matrix.csv"
+echo "Speedup table:  $out/speedup.md"
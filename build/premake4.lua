@@ -24,6 +24,17 @@ function setTargetObjDir(outDir)
 	end
 end
 
+newoption {
+	trigger = "dtoa-stats",
+	description = "Count Grisu3 success/bail-out and bignum paths in double-conversion"
+}
+
+newoption {
+	trigger = "std",
+	value = "STANDARD",
+	description = "C++ standard for gmake builds, e.g. c++17 (default) or c++20"
+}
+
 solution "benchmark"
 	configurations { "debug", "release" }
 	platforms { "x32", "x64" }
@@ -47,6 +58,25 @@ solution "benchmark"
 	configuration "gmake"
 		buildoptions "-msse4.2 -Wall -Wextra"
 
+	configuration "dtoa-stats"
+		defines { "DOUBLE_CONVERSION_STATS=1" }
+
+	-- The C implementations are a project of their own: premake4 passes
+	-- buildoptions to C and C++ sources alike, and the C++ standard below
+	-- must not reach the C compiler.
+	project "dtoa_c"
+		kind "StaticLib"
+		language "C"
+
+		files {
+			"../src/**.h",
+			"../src/**.c",
+		}
+
+		includedirs { "..", "../src" }
+
+		setTargetObjDir("../bin")
+
 	project "dtoa"
 		kind "ConsoleApp"
 		
@@ -54,7 +84,21 @@ solution "benchmark"
 			"../src/**.h",
 			"../src/**.cpp",
 			"../src/**.cc",
-			"../src/**.c",
+			"../stb_sprintf.cpp",
 		}
 
+		includedirs { "..", "../src" }
+
+		links { "dtoa_c" }
+
+		configuration "vs*"
+			buildoptions "/std:c++latest /Zc:__cplusplus"
+
+		-- BenchPipeline() runs std::thread workers.
+		configuration "gmake"
+			buildoptions ("-std=" .. (_OPTIONS["std"] or "c++17") .. " -pthread")
+			linkoptions "-pthread"
+
+		configuration {}
+
 		setTargetObjDir("../bin")
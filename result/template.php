@@ -15,10 +15,10 @@ $(function() {
         onParseValue: $.csv.hooks.castToScalar
     });
 
-    // Convert data for bar chart (summing all digits)
+    // Convert data for bar chart (averaging over the digits of each type)
     var timeData = {};	// type -> table
-    var funcRowMap;
-    var maxDigit = 0;
+    var countData = {};	// type -> number of rows summed into each table row
+    var funcRowMap = {};	// type -> (func -> table row)
 
     for (var i = 1; i < data.length; i++) {
     	var type = data[i][0];
@@ -27,29 +27,35 @@ $(function() {
    		var time = data[i][3];
    		if (timeData[type] == null) {
    			timeData[type] = [["Function", "Time (ns)"/*, { role: "style" }*/]];
-        if (digit != 0)
-   			  funcRowMap = {};
+   			countData[type] = [0];
+   			funcRowMap[type] = {};
    		}
 
    		var table = timeData[type];
+   		var count = countData[type];
+   		var rowMap = funcRowMap[type];
    		
       if (digit != 0) {
-     		if (funcRowMap[func] == null)
-     			funcRowMap[func] = table.push([func, 0]) - 1;
+     		if (rowMap[func] == null) {
+     			rowMap[func] = table.push([func, 0]) - 1;
+     			count.push(0);
+     		}
      		
-     		table[funcRowMap[func]][1] += time;
+     		table[rowMap[func]][1] += time;
+     		count[rowMap[func]]++;
       }
-      else 
+      else {
         table.push([func, time]);
-
-      maxDigit = Math.max(maxDigit, digit);
+        count.push(1);
+      }
     }
 
     // Compute average
     for (var type in timeData) {
       var table = timeData[type];
+      var count = countData[type];
       for (var i = 1; i < table.length; i++)
-        table[i][1] /= maxDigit;
+        table[i][1] /= count[i];
     }
 
     // Convert data for drawing line chart per random digit
@@ -0,0 +1,306 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "alloccounter.h"
+
+#if _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+static size_t gAllocationCount;
+static size_t gAllocationBytes;
+
+#if defined(__GNUC__)
+#define ALLOCCOUNTER_ADD(counter, value) __atomic_fetch_add(&counter, value, __ATOMIC_RELAXED)
+#define ALLOCCOUNTER_LOAD(counter) __atomic_load_n(&counter, __ATOMIC_RELAXED)
+#elif _WIN64
+#define ALLOCCOUNTER_ADD(counter, value) InterlockedExchangeAdd64((volatile LONG64*)&counter, (LONG64)(value))
+#define ALLOCCOUNTER_LOAD(counter) (*(volatile size_t*)&counter)
+#else
+#define ALLOCCOUNTER_ADD(counter, value) InterlockedExchangeAdd((volatile LONG*)&counter, (LONG)(value))
+#define ALLOCCOUNTER_LOAD(counter) (*(volatile size_t*)&counter)
+#endif
+
+static inline void CountAllocation(size_t size) {
+	ALLOCCOUNTER_ADD(gAllocationCount, 1);
+	ALLOCCOUNTER_ADD(gAllocationBytes, size);
+}
+
+#if defined(__GLIBC__)
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+extern "C" {
+
+void* malloc(size_t size) {
+	CountAllocation(size);
+	return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+	CountAllocation(count * size);
+	return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+	CountAllocation(size);
+	return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+	CountAllocation(size);
+	return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+	CountAllocation(size);
+	return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** memptr, size_t alignment, size_t size) {
+	if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+		return EINVAL;
+	CountAllocation(size);
+	void* p = __libc_memalign(alignment, size);
+	if (!p)
+		return ENOMEM;
+	*memptr = p;
+	return 0;
+}
+
+}
+
+// operator new below goes around the interposed malloc, so that a new is
+// not counted twice.
+#define ALLOCCOUNTER_MALLOC __libc_malloc
+#define ALLOCCOUNTER_FREE __libc_free
+#define ALLOCCOUNTER_ALIGNED_MALLOC(alignment, size) __libc_memalign(alignment, size)
+#define ALLOCCOUNTER_ALIGNED_FREE __libc_free
+
+bool AllocationCounterEnabled() {
+	return true;
+}
+
+#else
+
+#define ALLOCCOUNTER_MALLOC std::malloc
+#define ALLOCCOUNTER_FREE std::free
+
+#if _WIN32
+#define ALLOCCOUNTER_ALIGNED_MALLOC(alignment, size) _aligned_malloc(size, alignment)
+#define ALLOCCOUNTER_ALIGNED_FREE _aligned_free
+#else
+static void* AlignedMalloc(size_t alignment, size_t size) {
+	void* p;
+	return posix_memalign(&p, alignment, size) == 0 ? p : 0;
+}
+
+#define ALLOCCOUNTER_ALIGNED_MALLOC(alignment, size) AlignedMalloc(alignment, size)
+#define ALLOCCOUNTER_ALIGNED_FREE std::free
+#endif
+
+bool AllocationCounterEnabled() {
+	return false;
+}
+
+#endif
+
+static void* CountedNew(size_t size) {
+	if (size == 0)
+		size = 1;
+	CountAllocation(size);
+	void* p;
+	while ((p = ALLOCCOUNTER_MALLOC(size)) == 0) {
+		std::new_handler handler = std::set_new_handler(0);
+		std::set_new_handler(handler);
+		if (!handler)
+			throw std::bad_alloc();
+		handler();
+	}
+	return p;
+}
+
+void* operator new(size_t size) {
+	return CountedNew(size);
+}
+
+void* operator new[](size_t size) {
+	return CountedNew(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) throw() {
+	try {
+		return CountedNew(size);
+	}
+	catch (...) {
+		return 0;
+	}
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) throw() {
+	try {
+		return CountedNew(size);
+	}
+	catch (...) {
+		return 0;
+	}
+}
+
+void operator delete(void* p) throw() {
+	ALLOCCOUNTER_FREE(p);
+}
+
+void operator delete[](void* p) throw() {
+	ALLOCCOUNTER_FREE(p);
+}
+
+#if __cpp_sized_deallocation
+void operator delete(void* p, size_t) throw() {
+	ALLOCCOUNTER_FREE(p);
+}
+
+void operator delete[](void* p, size_t) throw() {
+	ALLOCCOUNTER_FREE(p);
+}
+#endif
+
+void operator delete(void* p, const std::nothrow_t&) throw() {
+	ALLOCCOUNTER_FREE(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) throw() {
+	ALLOCCOUNTER_FREE(p);
+}
+
+#if __cpp_aligned_new
+// Over-aligned types (alignas above the malloc alignment) come here.
+static void* CountedAlignedNew(size_t size, std::align_val_t alignment) {
+	if (size == 0)
+		size = 1;
+	size_t align = static_cast<size_t>(alignment);
+	if (align < sizeof(void*))
+		align = sizeof(void*);
+	CountAllocation(size);
+	void* p;
+	while ((p = ALLOCCOUNTER_ALIGNED_MALLOC(align, size)) == 0) {
+		std::new_handler handler = std::set_new_handler(0);
+		std::set_new_handler(handler);
+		if (!handler)
+			throw std::bad_alloc();
+		handler();
+	}
+	return p;
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+	return CountedAlignedNew(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+	return CountedAlignedNew(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	try {
+		return CountedAlignedNew(size, alignment);
+	}
+	catch (...) {
+		return 0;
+	}
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	try {
+		return CountedAlignedNew(size, alignment);
+	}
+	catch (...) {
+		return 0;
+	}
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+	ALLOCCOUNTER_ALIGNED_FREE(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+	ALLOCCOUNTER_ALIGNED_FREE(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+	ALLOCCOUNTER_ALIGNED_FREE(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+	ALLOCCOUNTER_ALIGNED_FREE(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+	ALLOCCOUNTER_ALIGNED_FREE(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+	ALLOCCOUNTER_ALIGNED_FREE(p);
+}
+#endif
+
+AllocationStats GetAllocationStats() {
+	AllocationStats stats;
+	stats.count = ALLOCCOUNTER_LOAD(gAllocationCount);
+	stats.bytes = ALLOCCOUNTER_LOAD(gAllocationBytes);
+	return stats;
+}
+
+size_t GetPeakRss() {
+#if _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize;
+	return 0;
+#else
+#if __linux__
+	// VmHWM is the peak that ResetPeakRss() restarts; ru_maxrss is not reset.
+	FILE* fp = fopen("/proc/self/status", "r");
+	if (fp) {
+		char line[256];
+		unsigned long kb = 0;
+		bool found = false;
+		while (!found && fgets(line, sizeof(line), fp))
+			found = strncmp(line, "VmHWM:", 6) == 0 && sscanf(line + 6, "%lu", &kb) == 1;
+		fclose(fp);
+		if (found)
+			return (size_t)kb * 1024;
+	}
+#endif
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#if __APPLE__
+	return (size_t)usage.ru_maxrss;	// bytes
+#else
+	return (size_t)usage.ru_maxrss * 1024;	// kilobytes
+#endif
+#endif
+}
+
+void ResetPeakRss() {
+#if __linux__
+	// "5" resets the peak RSS to the current RSS (Linux 4.0 and later).
+	FILE* fp = fopen("/proc/self/clear_refs", "w");
+	if (fp) {
+		fputs("5", fp);
+		fclose(fp);
+	}
+#endif
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stddef.h>
+
+// Counts heap allocations of the whole process. Global operator new and
+// delete, including the aligned forms of C++17, are replaced everywhere; with
+// glibc, malloc, calloc, realloc, memalign, aligned_alloc and posix_memalign
+// are interposed as well, reaching the originals as __libc_malloc etc.
+// Elsewhere only C++ allocations are counted.
+
+struct AllocationStats {
+	size_t count;	// number of allocations, a realloc counts as one
+	size_t bytes;	// bytes requested by them
+};
+
+// Returns true if malloc is counted, and not only operator new.
+bool AllocationCounterEnabled();
+
+// Allocations since program start. Take the difference of two calls to
+// attribute allocations to a test.
+AllocationStats GetAllocationStats();
+
+// Peak resident set size of the process in bytes, 0 if unknown. On Linux it is
+// VmHWM of /proc/self/status, elsewhere the high-water mark of the process.
+size_t GetPeakRss();
+
+// Restarts peak RSS tracking from the current RSS. Only supported on Linux
+// (/proc/self/clear_refs); elsewhere GetPeakRss() stays the process maximum.
+void ResetPeakRss();
@@ -30,6 +30,8 @@
 #include "bignum-dtoa.h"
 
 #include "bignum.h"
+#include "bignum64.h"
+#include "dtoa-stats.h"
 #include "ieee.h"
 
 namespace double_conversion {
@@ -49,47 +51,58 @@ static int NormalizedExponent(uint64_t significand, int exponent) {
 static int EstimatePower(int exponent);
 // Computes v / 10^estimated_power exactly, as a ratio of two bignums, numerator
 // and denominator.
+template <typename BignumType>
 static void InitialScaledStartValues(uint64_t significand,
                                      int exponent,
                                      bool lower_boundary_is_closer,
                                      int estimated_power,
                                      bool need_boundary_deltas,
-                                     Bignum* numerator,
-                                     Bignum* denominator,
-                                     Bignum* delta_minus,
-                                     Bignum* delta_plus);
+                                     BignumType* numerator,
+                                     BignumType* denominator,
+                                     BignumType* delta_minus,
+                                     BignumType* delta_plus);
 // Multiplies numerator/denominator so that its values lies in the range 1-10.
 // Returns decimal_point s.t.
 //  v = numerator'/denominator' * 10^(decimal_point-1)
 //     where numerator' and denominator' are the values of numerator and
 //     denominator after the call to this function.
+template <typename BignumType>
 static void FixupMultiply10(int estimated_power, bool is_even,
                             int* decimal_point,
-                            Bignum* numerator, Bignum* denominator,
-                            Bignum* delta_minus, Bignum* delta_plus);
+                            BignumType* numerator, BignumType* denominator,
+                            BignumType* delta_minus, BignumType* delta_plus);
 // Generates digits from the left to the right and stops when the generated
 // digits yield the shortest decimal representation of v.
-static void GenerateShortestDigits(Bignum* numerator, Bignum* denominator,
-                                   Bignum* delta_minus, Bignum* delta_plus,
+template <typename BignumType>
+static void GenerateShortestDigits(BignumType* numerator,
+                                   BignumType* denominator,
+                                   BignumType* delta_minus,
+                                   BignumType* delta_plus,
                                    bool is_even,
                                    Vector<char> buffer, int* length);
 // Generates 'requested_digits' after the decimal point.
+template <typename BignumType>
 static void BignumToFixed(int requested_digits, int* decimal_point,
-                          Bignum* numerator, Bignum* denominator,
+                          BignumType* numerator, BignumType* denominator,
                           Vector<char>(buffer), int* length);
 // Generates 'count' digits of numerator/denominator.
 // Once 'count' digits have been produced rounds the result depending on the
 // remainder (remainders of exactly .5 round upwards). Might update the
 // decimal_point when rounding up (for example for 0.9999).
+template <typename BignumType>
 static void GenerateCountedDigits(int count, int* decimal_point,
-                                  Bignum* numerator, Bignum* denominator,
+                                  BignumType* numerator,
+                                  BignumType* denominator,
                                   Vector<char>(buffer), int* length);
 
 
-void BignumDtoa(double v, BignumDtoaMode mode, int requested_digits,
-                Vector<char> buffer, int* length, int* decimal_point) {
+template <typename BignumType>
+static void BignumDtoaImpl(double v, BignumDtoaMode mode,
+                           int requested_digits, Vector<char> buffer,
+                           int* length, int* decimal_point) {
   ASSERT(v > 0);
   ASSERT(!Double(v).IsSpecial());
+  DOUBLE_CONVERSION_COUNT(bignum);
   uint64_t significand;
   int exponent;
   bool lower_boundary_is_closer;
@@ -126,15 +139,15 @@ void BignumDtoa(double v, BignumDtoaMode mode, int requested_digits,
     return;
   }
 
-  Bignum numerator;
-  Bignum denominator;
-  Bignum delta_minus;
-  Bignum delta_plus;
+  BignumType numerator;
+  BignumType denominator;
+  BignumType delta_minus;
+  BignumType delta_plus;
   // Make sure the bignum can grow large enough. The smallest double equals
   // 4e-324. In this case the denominator needs fewer than 324*4 binary digits.
   // The maximum double is 1.7976931348623157e308 which needs fewer than
   // 308*4 binary digits.
-  ASSERT(Bignum::kMaxSignificantBits >= 324*4);
+  ASSERT(BignumType::kMaxSignificantBits >= 324*4);
   InitialScaledStartValues(significand, exponent, lower_boundary_is_closer,
                            estimated_power, need_boundary_deltas,
                            &numerator, &denominator,
@@ -169,6 +182,22 @@ void BignumDtoa(double v, BignumDtoaMode mode, int requested_digits,
 }
 
 
+void BignumDtoa(double v, BignumDtoaMode mode, int requested_digits,
+                Vector<char> buffer, int* length, int* decimal_point) {
+  BignumDtoaImpl<Bignum>(v, mode, requested_digits, buffer, length,
+                         decimal_point);
+}
+
+
+#if DOUBLE_CONVERSION_HAS_BIGNUM64
+void BignumDtoa64(double v, BignumDtoaMode mode, int requested_digits,
+                  Vector<char> buffer, int* length, int* decimal_point) {
+  BignumDtoaImpl<Bignum64>(v, mode, requested_digits, buffer, length,
+                           decimal_point);
+}
+#endif
+
+
 // The procedure starts generating digits from the left to the right and stops
 // when the generated digits yield the shortest decimal representation of v. A
 // decimal representation of v is a number lying closer to v than to any other
@@ -182,13 +211,16 @@ void BignumDtoa(double v, BignumDtoaMode mode, int requested_digits,
 // Precondition: 0 <= (numerator+delta_plus) / denominator < 10.
 //   If 1 <= (numerator+delta_plus) / denominator < 10 then no leading 0 digit
 //   will be produced. This should be the standard precondition.
-static void GenerateShortestDigits(Bignum* numerator, Bignum* denominator,
-                                   Bignum* delta_minus, Bignum* delta_plus,
+template <typename BignumType>
+static void GenerateShortestDigits(BignumType* numerator,
+                                   BignumType* denominator,
+                                   BignumType* delta_minus,
+                                   BignumType* delta_plus,
                                    bool is_even,
                                    Vector<char> buffer, int* length) {
   // Small optimization: if delta_minus and delta_plus are the same just reuse
   // one of the two bignums.
-  if (Bignum::Equal(*delta_minus, *delta_plus)) {
+  if (BignumType::Equal(*delta_minus, *delta_plus)) {
     delta_plus = delta_minus;
   }
   *length = 0;
@@ -208,16 +240,16 @@ static void GenerateShortestDigits(Bignum* numerator, Bignum* denominator,
     bool in_delta_room_minus;
     bool in_delta_room_plus;
     if (is_even) {
-      in_delta_room_minus = Bignum::LessEqual(*numerator, *delta_minus);
+      in_delta_room_minus = BignumType::LessEqual(*numerator, *delta_minus);
     } else {
-      in_delta_room_minus = Bignum::Less(*numerator, *delta_minus);
+      in_delta_room_minus = BignumType::Less(*numerator, *delta_minus);
     }
     if (is_even) {
       in_delta_room_plus =
-          Bignum::PlusCompare(*numerator, *delta_plus, *denominator) >= 0;
+          BignumType::PlusCompare(*numerator, *delta_plus, *denominator) >= 0;
     } else {
       in_delta_room_plus =
-          Bignum::PlusCompare(*numerator, *delta_plus, *denominator) > 0;
+          BignumType::PlusCompare(*numerator, *delta_plus, *denominator) > 0;
     }
     if (!in_delta_room_minus && !in_delta_room_plus) {
       // Prepare for next iteration.
@@ -232,7 +264,8 @@ static void GenerateShortestDigits(Bignum* numerator, Bignum* denominator,
     } else if (in_delta_room_minus && in_delta_room_plus) {
       // Let's see if 2*numerator < denominator.
       // If yes, then the next digit would be < 5 and we can round down.
-      int compare = Bignum::PlusCompare(*numerator, *numerator, *denominator);
+      int compare =
+          BignumType::PlusCompare(*numerator, *numerator, *denominator);
       if (compare < 0) {
         // Remaining digits are less than .5. -> Round down (== do nothing).
       } else if (compare > 0) {
@@ -280,8 +313,10 @@ static void GenerateShortestDigits(Bignum* numerator, Bignum* denominator,
 // to round up or down. Remainders of exactly .5 round upwards. Numbers such
 // as 9.999999 propagate a carry all the way, and change the
 // exponent (decimal_point), when rounding upwards.
+template <typename BignumType>
 static void GenerateCountedDigits(int count, int* decimal_point,
-                                  Bignum* numerator, Bignum* denominator,
+                                  BignumType* numerator,
+                                  BignumType* denominator,
                                   Vector<char> buffer, int* length) {
   ASSERT(count >= 0);
   for (int i = 0; i < count - 1; ++i) {
@@ -297,7 +332,7 @@ static void GenerateCountedDigits(int count, int* decimal_point,
   // Generate the last digit.
   uint16_t digit;
   digit = numerator->DivideModuloIntBignum(*denominator);
-  if (Bignum::PlusCompare(*numerator, *numerator, *denominator) >= 0) {
+  if (BignumType::PlusCompare(*numerator, *numerator, *denominator) >= 0) {
     digit++;
   }
   ASSERT(digit <= 10);
@@ -323,8 +358,9 @@ static void GenerateCountedDigits(int count, int* decimal_point,
 // generated (ex.: 2 fixed digits for 0.00001).
 //
 // Input verifies:  1 <= (numerator + delta) / denominator < 10.
+template <typename BignumType>
 static void BignumToFixed(int requested_digits, int* decimal_point,
-                          Bignum* numerator, Bignum* denominator,
+                          BignumType* numerator, BignumType* denominator,
                           Vector<char>(buffer), int* length) {
   // Note that we have to look at more than just the requested_digits, since
   // a number could be rounded up. Example: v=0.5 with requested_digits=0.
@@ -345,7 +381,7 @@ static void BignumToFixed(int requested_digits, int* decimal_point,
     // Initially the fraction lies in range (1, 10]. Multiply the denominator
     // by 10 so that we can compare more easily.
     denominator->Times10();
-    if (Bignum::PlusCompare(*numerator, *numerator, *denominator) >= 0) {
+    if (BignumType::PlusCompare(*numerator, *numerator, *denominator) >= 0) {
       // If the fraction is >= 0.5 then we have to include the rounded
       // digit.
       buffer[0] = '1';
@@ -414,11 +450,12 @@ static int EstimatePower(int exponent) {
 
 
 // See comments for InitialScaledStartValues.
+template <typename BignumType>
 static void InitialScaledStartValuesPositiveExponent(
     uint64_t significand, int exponent,
     int estimated_power, bool need_boundary_deltas,
-    Bignum* numerator, Bignum* denominator,
-    Bignum* delta_minus, Bignum* delta_plus) {
+    BignumType* numerator, BignumType* denominator,
+    BignumType* delta_minus, BignumType* delta_plus) {
   // A positive exponent implies a positive power.
   ASSERT(estimated_power >= 0);
   // Since the estimated_power is positive we simply multiply the denominator
@@ -447,11 +484,12 @@ static void InitialScaledStartValuesPositiveExponent(
 
 
 // See comments for InitialScaledStartValues
+template <typename BignumType>
 static void InitialScaledStartValuesNegativeExponentPositivePower(
     uint64_t significand, int exponent,
     int estimated_power, bool need_boundary_deltas,
-    Bignum* numerator, Bignum* denominator,
-    Bignum* delta_minus, Bignum* delta_plus) {
+    BignumType* numerator, BignumType* denominator,
+    BignumType* delta_minus, BignumType* delta_plus) {
   // v = f * 2^e with e < 0, and with estimated_power >= 0.
   // This means that e is close to 0 (have a look at how estimated_power is
   // computed).
@@ -481,16 +519,17 @@ static void InitialScaledStartValuesNegativeExponentPositivePower(
 
 
 // See comments for InitialScaledStartValues
+template <typename BignumType>
 static void InitialScaledStartValuesNegativeExponentNegativePower(
     uint64_t significand, int exponent,
     int estimated_power, bool need_boundary_deltas,
-    Bignum* numerator, Bignum* denominator,
-    Bignum* delta_minus, Bignum* delta_plus) {
+    BignumType* numerator, BignumType* denominator,
+    BignumType* delta_minus, BignumType* delta_plus) {
   // Instead of multiplying the denominator with 10^estimated_power we
   // multiply all values (numerator and deltas) by 10^-estimated_power.
 
   // Use numerator as temporary container for power_ten.
-  Bignum* power_ten = numerator;
+  BignumType* power_ten = numerator;
   power_ten->AssignPowerUInt16(10, -estimated_power);
 
   if (need_boundary_deltas) {
@@ -565,15 +604,16 @@ static void InitialScaledStartValuesNegativeExponentNegativePower(
 // The boundary-deltas are only filled if the mode equals BIGNUM_DTOA_SHORTEST
 // or BIGNUM_DTOA_SHORTEST_SINGLE.
 
+template <typename BignumType>
 static void InitialScaledStartValues(uint64_t significand,
                                      int exponent,
                                      bool lower_boundary_is_closer,
                                      int estimated_power,
                                      bool need_boundary_deltas,
-                                     Bignum* numerator,
-                                     Bignum* denominator,
-                                     Bignum* delta_minus,
-                                     Bignum* delta_plus) {
+                                     BignumType* numerator,
+                                     BignumType* denominator,
+                                     BignumType* delta_minus,
+                                     BignumType* delta_plus) {
   if (exponent >= 0) {
     InitialScaledStartValuesPositiveExponent(
         significand, exponent, estimated_power, need_boundary_deltas,
@@ -609,17 +649,20 @@ static void InitialScaledStartValues(uint64_t significand,
 // then simply adjust the power so that 10^(k-1) <= v < 10^k (with k ==
 // estimated_power) but do not touch the numerator or denominator.
 // Otherwise the routine multiplies the numerator and the deltas by 10.
+template <typename BignumType>
 static void FixupMultiply10(int estimated_power, bool is_even,
                             int* decimal_point,
-                            Bignum* numerator, Bignum* denominator,
-                            Bignum* delta_minus, Bignum* delta_plus) {
+                            BignumType* numerator, BignumType* denominator,
+                            BignumType* delta_minus, BignumType* delta_plus) {
   bool in_range;
   if (is_even) {
     // For IEEE doubles half-way cases (in decimal system numbers ending with 5)
     // are rounded to the closest floating-point number with even significand.
-    in_range = Bignum::PlusCompare(*numerator, *delta_plus, *denominator) >= 0;
+    in_range =
+        BignumType::PlusCompare(*numerator, *delta_plus, *denominator) >= 0;
   } else {
-    in_range = Bignum::PlusCompare(*numerator, *delta_plus, *denominator) > 0;
+    in_range =
+        BignumType::PlusCompare(*numerator, *delta_plus, *denominator) > 0;
   }
   if (in_range) {
     // Since numerator + delta_plus >= denominator we already have
@@ -628,7 +671,7 @@ static void FixupMultiply10(int estimated_power, bool is_even,
   } else {
     *decimal_point = estimated_power;
     numerator->Times10();
-    if (Bignum::Equal(*delta_minus, *delta_plus)) {
+    if (BignumType::Equal(*delta_minus, *delta_plus)) {
       delta_minus->Times10();
       delta_plus->AssignBignum(*delta_minus);
     } else {
@@ -29,6 +29,7 @@
 #define DOUBLE_CONVERSION_BIGNUM_DTOA_H_
 
 #include "utils.h"
+#include "bignum64.h"
 
 namespace double_conversion {
 
@@ -79,6 +80,13 @@ enum BignumDtoaMode {
 void BignumDtoa(double v, BignumDtoaMode mode, int requested_digits,
                 Vector<char> buffer, int* length, int* point);
 
+#if DOUBLE_CONVERSION_HAS_BIGNUM64
+// Same as BignumDtoa, but computes with Bignum64 (64-bit chunks and 128-bit
+// products) instead of Bignum. The output is identical.
+void BignumDtoa64(double v, BignumDtoaMode mode, int requested_digits,
+                  Vector<char> buffer, int* length, int* point);
+#endif
+
 }  // namespace double_conversion
 
 #endif  // DOUBLE_CONVERSION_BIGNUM_DTOA_H_
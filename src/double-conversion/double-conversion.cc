@@ -39,6 +39,10 @@
 
 namespace double_conversion {
 
+static BignumDtoaMode DtoaToBignumDtoaMode(
+    DoubleToStringConverter::DtoaMode dtoa_mode);
+
+
 const DoubleToStringConverter& DoubleToStringConverter::EcmaScriptConverter() {
   int flags = UNIQUE_ZERO | EMIT_POSITIVE_EXPONENT_SIGN;
   static DoubleToStringConverter converter(flags,
@@ -196,6 +200,125 @@ bool DoubleToStringConverter::ToShortestIeeeNumber(
 }
 
 
+int DoubleToStringConverter::ToShortestIeeeNumberDirect(
+    double value,
+    char* buffer,
+    int buffer_length,
+    DoubleToStringConverter::DtoaMode mode) const {
+  ASSERT(mode == SHORTEST || mode == SHORTEST_SINGLE);
+  ASSERT(buffer_length >= kBase10MaximalLength + 8 +
+         Max(-decimal_in_shortest_low_, decimal_in_shortest_high_));
+  if (Double(value).IsSpecial()) {
+    StringBuilder result_builder(buffer, buffer_length);
+    if (!HandleSpecialValues(value, &result_builder)) return -1;
+    return result_builder.position();
+  }
+
+  char* p = buffer;
+  bool unique_zero = (flags_ & UNIQUE_ZERO) != 0;
+  if (Double(value).Sign() < 0) {
+    if (value != 0.0 || !unique_zero) *p++ = '-';
+    value = -value;
+  }
+
+  // Generate the digits at their final position for the most common layout
+  // ("digits" or "digits.digits"), and shift them for the others.
+  int length;
+  int decimal_point;
+  if (value == 0) {
+    p[0] = '0';
+    length = 1;
+    decimal_point = 1;
+  } else {
+    Vector<char> digits(p, buffer_length - static_cast<int>(p - buffer));
+    bool fast_worked = (mode == SHORTEST)
+        ? FastDtoa(value, FAST_DTOA_SHORTEST, 0, digits, &length,
+                   &decimal_point)
+        : FastDtoa(value, FAST_DTOA_SHORTEST_SINGLE, 0, digits, &length,
+                   &decimal_point);
+    if (!fast_worked) {
+      BignumDtoa(value, DtoaToBignumDtoaMode(mode), 0, digits, &length,
+                 &decimal_point);
+    }
+  }
+
+  return static_cast<int>(p - buffer) +
+         DigitsToShortest(p, length, decimal_point);
+}
+
+
+int DoubleToStringConverter::DigitsToShortest(char* buffer,
+                                              int length,
+                                              int decimal_point) const {
+  int exponent = decimal_point - 1;
+  if (exponent < decimal_in_shortest_low_ ||
+      exponent >= decimal_in_shortest_high_) {
+    return DigitsToExponential(buffer, length, decimal_point);
+  }
+
+  char* p = buffer;
+  if (decimal_point <= 0) {
+    // "0.00000digits".
+    int offset = 2 - decimal_point;
+    memmove(p + offset, p, length);
+    p[0] = '0';
+    p[1] = '.';
+    for (int i = 2; i < offset; ++i) p[i] = '0';
+    p += offset + length;
+  } else if (decimal_point >= length) {
+    // "digits0000" or "digits0000.0"
+    for (int i = length; i < decimal_point; ++i) p[i] = '0';
+    p += decimal_point;
+    if ((flags_ & EMIT_TRAILING_DECIMAL_POINT) != 0) *p++ = '.';
+    if ((flags_ & EMIT_TRAILING_ZERO_AFTER_POINT) != 0) *p++ = '0';
+  } else {
+    // "digi.ts"
+    memmove(p + decimal_point + 1, p + decimal_point,
+            length - decimal_point);
+    p[decimal_point] = '.';
+    p += length + 1;
+  }
+  *p = '\0';
+  return static_cast<int>(p - buffer);
+}
+
+
+int DoubleToStringConverter::DigitsToExponential(char* buffer,
+                                                 int length,
+                                                 int decimal_point) const {
+  // "d.igitse+123"
+  char* p = buffer;
+  int exponent = decimal_point - 1;
+  if (length != 1) {
+    memmove(p + 2, p + 1, length - 1);
+    p[1] = '.';
+    p += length + 1;
+  } else {
+    p += 1;
+  }
+  *p++ = exponent_character_;
+  if (exponent < 0) {
+    *p++ = '-';
+    exponent = -exponent;
+  } else if ((flags_ & EMIT_POSITIVE_EXPONENT_SIGN) != 0) {
+    *p++ = '+';
+  }
+  ASSERT(exponent < 1e4);
+  if (exponent >= 100) {
+    *p++ = static_cast<char>('0' + exponent / 100);
+    exponent %= 100;
+    *p++ = static_cast<char>('0' + exponent / 10);
+    exponent %= 10;
+  } else if (exponent >= 10) {
+    *p++ = static_cast<char>('0' + exponent / 10);
+    exponent %= 10;
+  }
+  *p++ = static_cast<char>('0' + exponent);
+  *p = '\0';
+  return static_cast<int>(p - buffer);
+}
+
+
 bool DoubleToStringConverter::ToFixed(double value,
                                       int requested_digits,
                                       StringBuilder* result_builder) const {
@@ -163,6 +163,43 @@ class DoubleToStringConverter {
     return ToShortestIeeeNumber(value, result_builder, SHORTEST_SINGLE);
   }
 
+  // Same as ToShortest, but writes the null-terminated result directly into
+  // 'buffer'. The digits are generated in place and then shifted into their
+  // decimal or exponential layout, so no intermediate copy or StringBuilder
+  // is involved.
+  // 'buffer_length' must be at least
+  //   kBase10MaximalLength + 8 + max(-decimal_in_shortest_low,
+  //                                  decimal_in_shortest_high)
+  // (25 + 21 = 46 for the EcmaScript converter). It is only checked in debug
+  // mode.
+  // Returns the number of characters written, not including the terminating
+  // null character. Returns -1 if the input value is special and no
+  // infinity_symbol or nan_symbol has been given to the constructor.
+  int ToShortestDirect(double value, char* buffer, int buffer_length) const {
+    return ToShortestIeeeNumberDirect(value, buffer, buffer_length, SHORTEST);
+  }
+
+  // Same as ToShortestDirect, but for single-precision floats.
+  int ToShortestSingleDirect(float value,
+                             char* buffer,
+                             int buffer_length) const {
+    return ToShortestIeeeNumberDirect(value, buffer, buffer_length,
+                                      SHORTEST_SINGLE);
+  }
+
+  // The layout step of ToShortestDirect, for digits that come from elsewhere
+  // (e.g. BignumDtoa). 'buffer' starts with the 'length' digits of
+  // digits * 10^(decimal_point - length), which are moved in place into the
+  // decimal or exponential layout ToShortest would give them. 'buffer' must
+  // have the room ToShortestDirect asks for. The sign is up to the caller.
+  // Returns the number of characters written, not including the terminating
+  // null character.
+  int DigitsToShortest(char* buffer, int length, int decimal_point) const;
+
+  // Same as DigitsToShortest, but always in exponential layout
+  // ("d.igitse+123"), as ToExponential writes its digits.
+  int DigitsToExponential(char* buffer, int length, int decimal_point) const;
+
 
   // Computes a decimal representation with a fixed number of digits after the
   // decimal point. The last emitted digit is rounded.
@@ -347,6 +384,12 @@ class DoubleToStringConverter {
                             StringBuilder* result_builder,
                             DtoaMode mode) const;
 
+  // Implementation for ToShortestDirect and ToShortestSingleDirect.
+  int ToShortestIeeeNumberDirect(double value,
+                                 char* buffer,
+                                 int buffer_length,
+                                 DtoaMode mode) const;
+
   // If the value is a special value (NaN or Infinity) constructs the
   // corresponding string using the configured infinity/nan-symbol.
   // If either of them is NULL or the value is not special then the
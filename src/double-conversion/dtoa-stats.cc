@@ -0,0 +1,62 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "dtoa-stats.h"
+
+namespace double_conversion {
+
+#if DOUBLE_CONVERSION_STATS
+DtoaStats dtoa_stats = { 0, 0, 0 };
+#endif
+
+
+bool DtoaStatsEnabled() {
+  return DOUBLE_CONVERSION_STATS != 0;
+}
+
+
+void GetDtoaStats(DtoaStats* stats) {
+#if DOUBLE_CONVERSION_STATS
+  *stats = dtoa_stats;
+#else
+  stats->grisu3_success = 0;
+  stats->grisu3_bailout = 0;
+  stats->bignum = 0;
+#endif
+}
+
+
+void ResetDtoaStats() {
+#if DOUBLE_CONVERSION_STATS
+  dtoa_stats.grisu3_success = 0;
+  dtoa_stats.grisu3_bailout = 0;
+  dtoa_stats.bignum = 0;
+#endif
+}
+
+}  // namespace double_conversion
@@ -0,0 +1,71 @@
+// Copyright 2010 the V8 project authors. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of Google Inc. nor the names of its
+//       contributors may be used to endorse or promote products derived
+//       from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef DOUBLE_CONVERSION_DTOA_STATS_H_
+#define DOUBLE_CONVERSION_DTOA_STATS_H_
+
+#include "utils.h"
+
+// Define DOUBLE_CONVERSION_STATS to 1 to count which path every conversion
+// takes. The counters are plain (non-atomic) globals, so they are only exact
+// for single-threaded use. When disabled the counting compiles to nothing and
+// GetDtoaStats always reports zeros.
+#ifndef DOUBLE_CONVERSION_STATS
+#define DOUBLE_CONVERSION_STATS 0
+#endif
+
+namespace double_conversion {
+
+struct DtoaStats {
+  // FastDtoa calls (SHORTEST, SHORTEST_SINGLE and PRECISION) for which
+  // Grisu3 produced a result that can be trusted.
+  uint64_t grisu3_success;
+  // FastDtoa calls for which Grisu3 gave up.
+  uint64_t grisu3_bailout;
+  // BignumDtoa and BignumDtoa64 calls.
+  uint64_t bignum;
+};
+
+// Returns true if the library was compiled with DOUBLE_CONVERSION_STATS.
+bool DtoaStatsEnabled();
+
+// Copies the counters accumulated since the last ResetDtoaStats().
+void GetDtoaStats(DtoaStats* stats);
+
+void ResetDtoaStats();
+
+#if DOUBLE_CONVERSION_STATS
+extern DtoaStats dtoa_stats;
+#define DOUBLE_CONVERSION_COUNT(counter) (++dtoa_stats.counter)
+#else
+#define DOUBLE_CONVERSION_COUNT(counter) ((void)0)
+#endif
+
+}  // namespace double_conversion
+
+#endif  // DOUBLE_CONVERSION_DTOA_STATS_H_
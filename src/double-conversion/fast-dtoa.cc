@@ -29,6 +29,7 @@
 
 #include "cached-powers.h"
 #include "diy-fp.h"
+#include "dtoa-stats.h"
 #include "ieee.h"
 
 namespace double_conversion {
@@ -656,8 +657,11 @@ bool FastDtoa(double v,
       UNREACHABLE();
   }
   if (result) {
+    DOUBLE_CONVERSION_COUNT(grisu3_success);
     *decimal_point = *length + decimal_exponent;
     buffer[*length] = '\0';
+  } else {
+    DOUBLE_CONVERSION_COUNT(grisu3_bailout);
   }
   return result;
 }
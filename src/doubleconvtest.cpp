@@ -1,5 +1,8 @@
 #include "test.h"
 #include "double-conversion/double-conversion.h"
+#include "double-conversion/bignum-dtoa.h"
+#include "fixedformat.h"
+#include <string.h>
 
 using namespace double_conversion;
 
@@ -8,4 +11,109 @@ void dtoa_doubleconv(double value, char* buffer) {
 	DoubleToStringConverter::EcmaScriptConverter().ToShortest(value, &sb);
 }
 
+void dtoa_doubleconv_direct(double value, char* buffer) {
+	DoubleToStringConverter::EcmaScriptConverter().ToShortestDirect(value, buffer, 46);
+}
+
+void ftoa_doubleconv(float value, char* buffer) {
+	StringBuilder sb(buffer, 26);
+	DoubleToStringConverter::EcmaScriptConverter().ToShortestSingle(value, &sb);
+}
+
+void ftoa_doubleconv_direct(float value, char* buffer) {
+	DoubleToStringConverter::EcmaScriptConverter().ToShortestSingleDirect(value, buffer, 46);
+}
+
+// Always takes the exact bignum path that ToShortest only falls back to when
+// Grisu3 gives up, so every input costs as much as the worst case.
+template <void (*Dtoa)(double, BignumDtoaMode, int, Vector<char>, int*, int*)>
+static void dtoa_doubleconv_bignum_impl(double value, char* buffer) {
+	if (value == 0) {
+		strcpy(buffer, "0");
+		return;
+	}
+	if (value < 0) {
+		*buffer++ = '-';
+		value = -value;
+	}
+	int length, point;
+	Dtoa(value, BIGNUM_DTOA_SHORTEST, 0, Vector<char>(buffer, 18), &length, &point);
+	DoubleToStringConverter::EcmaScriptConverter().DigitsToShortest(buffer, length, point);
+}
+
+void dtoa_doubleconv_bignum(double value, char* buffer) {
+	dtoa_doubleconv_bignum_impl<BignumDtoa>(value, buffer);
+}
+
+#if DOUBLE_CONVERSION_HAS_BIGNUM64
+void dtoa_doubleconv_bignum64(double value, char* buffer) {
+	dtoa_doubleconv_bignum_impl<BignumDtoa64>(value, buffer);
+}
+#endif
+
+// NO_FLAGS keeps the sign of negative zero, as printf does.
+static const DoubleToStringConverter& FixedConverter() {
+	static const DoubleToStringConverter converter(DoubleToStringConverter::NO_FLAGS, "Infinity", "NaN", 'e', -6, 21, 6, 0);
+	return converter;
+}
+
+// ToFixed runs FastFixedDtoa and falls back to the bignum path when the value
+// or precision is out of its 128-bit range.
+void fixed_doubleconv(double value, int precision, char* buffer) {
+	StringBuilder sb(buffer, 1 + DoubleToStringConverter::kMaxFixedDigitsBeforePoint + 1 + DoubleToStringConverter::kMaxFixedDigitsAfterPoint + 1);
+	FixedConverter().ToFixed(value, precision, &sb);
+}
+
+// Always takes the exact bignum path; the reference for fixed verification.
+void fixed_doubleconv_bignum(double value, int precision, char* buffer) {
+	if (value < 0 || (value == 0 && 1 / value < 0)) {
+		*buffer++ = '-';
+		value = -value;
+	}
+	char digits[309 + DoubleToStringConverter::kMaxFixedDigitsAfterPoint + 1];
+	int length = 0, point = 0;
+	if (value != 0)
+		BignumDtoa(value, BIGNUM_DTOA_FIXED, precision, Vector<char>(digits, sizeof(digits)), &length, &point);
+	FormatFixed(digits, length, point, precision, buffer);
+}
+
+// ToExponential runs FastDtoa's counted Grisu3 and falls back to the bignum
+// path, then lays out the digits with CreateExponentialRepresentation.
+void exponential_doubleconv(double value, int digits, char* buffer) {
+	StringBuilder sb(buffer, DoubleToStringConverter::kMaxExponentialDigits + 8);
+	DoubleToStringConverter::EcmaScriptConverter().ToExponential(value, digits - 1, &sb);
+}
+
+// Always takes the exact bignum path.
+void exponential_doubleconv_bignum(double value, int digits, char* buffer) {
+	if (value < 0) {
+		*buffer++ = '-';
+		value = -value;
+	}
+	int length = 0, point = 1;
+	if (value != 0)
+		BignumDtoa(value, BIGNUM_DTOA_PRECISION, digits, Vector<char>(buffer, DoubleToStringConverter::kMaxPrecisionDigits + 1), &length, &point);
+	for (; length < digits; length++)
+		buffer[length] = '0';
+	DoubleToStringConverter::EcmaScriptConverter().DigitsToExponential(buffer, length, point);
+}
+
+double atod_doubleconv(const char* str) {
+	StringToDoubleConverter converter(StringToDoubleConverter::NO_FLAGS, 0.0, 0.0, NULL, NULL);
+	int processed;
+	return converter.StringToDouble(str, static_cast<int>(strlen(str)), &processed);
+}
+
 REGISTER_TEST(doubleconv);
+REGISTER_TEST(doubleconv_direct);
+REGISTER_TEST(doubleconv_bignum);
+#if DOUBLE_CONVERSION_HAS_BIGNUM64
+REGISTER_TEST(doubleconv_bignum64);
+#endif
+REGISTER_FLOAT_TEST(doubleconv);
+REGISTER_FLOAT_TEST(doubleconv_direct);
+REGISTER_ATOD_TEST(doubleconv);
+REGISTER_FIXED_TEST(doubleconv);
+REGISTER_FIXED_TEST(doubleconv_bignum);
+REGISTER_EXPONENTIAL_TEST(doubleconv);
+REGISTER_EXPONENTIAL_TEST(doubleconv_bignum);
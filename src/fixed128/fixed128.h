@@ -0,0 +1,137 @@
+#pragma once
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include "msinttypes/stdint.h"
+#else
+#include <stdint.h>
+#endif
+
+// Exact fixed precision formatting (printf "%.*f") in the spirit of Ryu printf
+// (Adams, PLDI 2019). Instead of generating digits from an approximation and
+// correcting them, the fraction bits are scaled by 10^precision in integer
+// arithmetic wide enough to hold the exact product, so a single shift and
+// comparison of the remainder give the correctly rounded result. Ryu printf
+// covers every double and precision with tables of precomputed 10^k / 2^e
+// blocks; this kernel covers precision <= 17 and values below 2^63, where the
+// significand times 10^precision fits in 128 bits, and reports anything else
+// to the caller. Halfway cases round to even, as glibc's printf does.
+
+namespace fixed128 {
+
+__extension__ typedef unsigned __int128 uint128;
+
+static const int kMaxPrecision = 17;
+
+inline const uint64_t* GetPow10() {
+	static const uint64_t kPow10[] = {
+		1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+		100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+		10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+		100000000000000000ULL
+	};
+	return kPow10;
+}
+
+inline const char* GetDigitsLut() {
+	static const char cDigitsLut[200] = {
+		'0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+		'1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+		'2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+		'3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+		'4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+		'5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+		'6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+		'7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+		'8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+		'9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+	};
+	return cDigitsLut;
+}
+
+// Writes exactly count digits of value, zero padded on the left.
+inline char* WritePadded(uint64_t value, int count, char* buffer) {
+	const char* cDigitsLut = GetDigitsLut();
+	char* p = buffer + count;
+	while (p - buffer >= 2) {
+		const unsigned i = static_cast<unsigned>(value % 100) * 2;
+		value /= 100;
+		*--p = cDigitsLut[i + 1];
+		*--p = cDigitsLut[i];
+	}
+	if (p != buffer)
+		*--p = static_cast<char>('0' + value % 10);
+	return buffer + count;
+}
+
+inline char* WriteUnsigned(uint64_t value, char* buffer) {
+	int count = 1;
+	for (uint64_t v = value; v >= 10 && count < 20; v /= 10)
+		count++;
+	return WritePadded(value, count, buffer);
+}
+
+// Returns false, writing nothing, when value or precision is out of range.
+inline bool Fixed(double value, int precision, char* buffer) {
+	if (precision < 0 || precision > kMaxPrecision)
+		return false;
+
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	const int biasedExponent = static_cast<int>(bits >> 52) & 0x7FF;
+	uint64_t significand = bits & ((uint64_t(1) << 52) - 1);
+	if (biasedExponent == 0x7FF)
+		return false;
+	int exponent = -1074;
+	if (biasedExponent != 0) {
+		significand |= uint64_t(1) << 52;
+		exponent = biasedExponent - 1075;
+	}
+
+	uint64_t integer, fraction;	// fraction holds the precision digits after the point
+	if (exponent >= 0) {
+		if (exponent > 10)
+			return false;	// 2^63 or more
+		integer = significand << exponent;
+		fraction = 0;
+	}
+	else {
+		const int shift = -exponent;
+		uint64_t fractionBits = significand;
+		integer = 0;
+		if (shift < 64) {
+			integer = significand >> shift;
+			fractionBits = significand & ((uint64_t(1) << shift) - 1);
+		}
+
+		// The fraction is exactly fractionBits / 2^shift, so fractionBits *
+		// 10^precision < 2^53 * 10^17 < 2^110 holds the scaled value exactly.
+		// From 2^-128 on it is below half a unit at any precision.
+		fraction = 0;
+		if (shift < 128) {
+			const uint128 scaled = static_cast<uint128>(fractionBits) * GetPow10()[precision];
+			fraction = static_cast<uint64_t>(scaled >> shift);
+			const uint128 remainder = scaled - (static_cast<uint128>(fraction) << shift);
+			const uint128 half = static_cast<uint128>(1) << (shift - 1);
+			const uint64_t last = precision > 0 ? fraction : integer;
+			if (remainder > half || (remainder == half && (last & 1))) {
+				if (++fraction == GetPow10()[precision]) {
+					fraction = 0;
+					integer++;
+				}
+			}
+		}
+	}
+
+	if (bits >> 63)
+		*buffer++ = '-';
+	buffer = WriteUnsigned(integer, buffer);
+	if (precision > 0) {
+		*buffer++ = '.';
+		buffer = WritePadded(fraction, precision, buffer);
+	}
+	*buffer = '\0';
+	return true;
+}
+
+} // namespace fixed128
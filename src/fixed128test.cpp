@@ -0,0 +1,28 @@
+#if defined(__SIZEOF_INT128__)
+
+#include <cmath>
+#include <cstdio>
+#include "test.h"
+#include "fixed128/fixed128.h"
+#include "double-conversion/double-conversion.h"
+
+using namespace double_conversion;
+
+// Values of 2^63 and above and precisions above 17 go to ToFixed, and past its
+// limits to sprintf, so every input is still formatted.
+void fixed_fixed128(double value, int precision, char* buffer) {
+	if (fixed128::Fixed(value, precision, buffer))
+		return;
+
+	if (precision <= DoubleToStringConverter::kMaxFixedDigitsAfterPoint && fabs(value) < 1e60) {
+		static const DoubleToStringConverter converter(DoubleToStringConverter::NO_FLAGS, "Infinity", "NaN", 'e', -6, 21, 6, 0);
+		StringBuilder sb(buffer, 1 + DoubleToStringConverter::kMaxFixedDigitsBeforePoint + 1 + DoubleToStringConverter::kMaxFixedDigitsAfterPoint + 1);
+		converter.ToFixed(value, precision, &sb);
+	}
+	else
+		sprintf(buffer, "%.*f", precision, value);
+}
+
+REGISTER_FIXED_TEST(fixed128);
+
+#endif // __SIZEOF_INT128__
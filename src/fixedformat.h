@@ -0,0 +1,20 @@
+#pragma once
+
+// Lays out digits * 10^(point - length) the way printf("%.*f") does: at least
+// one integer digit, then exactly precision fraction digits. The digits must
+// already be rounded to precision fraction digits; missing positions on either
+// side are zeros, so an empty digit string prints as zero.
+inline void FormatFixed(const char* digits, int length, int point, int precision, char* buffer) {
+	if (point <= 0)
+		*buffer++ = '0';
+	else
+		for (int i = 0; i < point; i++)
+			*buffer++ = i < length ? digits[i] : '0';
+
+	if (precision > 0) {
+		*buffer++ = '.';
+		for (int i = point; i < point + precision; i++)
+			*buffer++ = i >= 0 && i < length ? digits[i] : '0';
+	}
+	*buffer = '\0';
+}
@@ -19,7 +19,7 @@
 
 #include <string>
 
-#include <krosh.h>
+#include "krosh.h"
 
 #include "default_fallback.h"
 
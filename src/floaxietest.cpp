@@ -2,12 +2,25 @@
 
 #include "test.h"
 #include "floaxie/ftoa.h"
+#include "floaxie/atof.h"
 
 void dtoa_floaxie(double v, char* buffer)
 {
 	floaxie::ftoa(v, buffer);
 }
 
+void ftoa_floaxie(float v, char* buffer)
+{
+	floaxie::ftoa(v, buffer);
+}
+
+double atod_floaxie(const char* str)
+{
+	return floaxie::atof<double>(str, nullptr);
+}
+
 REGISTER_TEST(floaxie);
+REGISTER_FLOAT_TEST(floaxie);
+REGISTER_ATOD_TEST(floaxie);
 
 #endif
@@ -330,3 +330,59 @@ int fpconv_dtoa(double d, char dest[24])
 
     return str_len;
 }
+
+/* Converts one value of a batch. The sign is stored unconditionally and kept
+ * by advancing past it, and zero, inf and nan share one test on the bits, so
+ * the common path has a single, well predicted branch before grisu2. */
+static inline int dtoa_one(double d, char* dest)
+{
+    uint64_t bits = get_dbits(d);
+    int neg = (int)(bits >> 63);
+
+    dest[0] = '-';
+    dest += neg;
+
+    if((bits & expmask) == expmask || (bits & ~signmask) == 0) {
+        return neg + filter_special(d, dest);
+    }
+
+    char digits[18];
+    int K = 0;
+    int ndigits = grisu2(d, digits, &K);
+
+    return neg + emit_digits(digits, ndigits, dest, K, neg);
+}
+
+size_t fpconv_dtoa_many(const double* values, size_t count, char* dest, size_t cap, char sep, size_t* len)
+{
+    char* out = dest;
+    char* end = dest + cap;
+    size_t i = 0;
+
+    /* Room for the longest number and its separator: write in place without
+     * checking each value. Back to back conversions keep the powers_ten and
+     * tens tables in cache. */
+    for(; i < count && end - out >= 24 + 1; i++) {
+        out += dtoa_one(values[i], out);
+        *out++ = sep;
+    }
+
+    /* Near the end of dest: convert to scratch and copy only what fits. */
+    for(; i < count; i++) {
+        char tmp[24];
+        int n = dtoa_one(values[i], tmp);
+
+        if(end - out < n + 1) {
+            break;
+        }
+        memcpy(out, tmp, n);
+        out += n;
+        *out++ = sep;
+    }
+
+    if(len) {
+        *len = (size_t)(out - dest);
+    }
+
+    return i;
+}
@@ -1,6 +1,8 @@
 #ifndef FPCONV_H
 #define FPCONV_H
 
+#include <stddef.h>
+
 /* Fast and accurate double to string conversion based on Florian Loitsch's
  * Grisu-algorithm[1].
  *
@@ -28,6 +30,39 @@
 
 int fpconv_dtoa(double fp, char dest[24]);
 
+/* Batch conversion for streaming output.
+ *
+ * Input:
+ * values -> count doubles to convert, dest -> destination buffer of cap
+ * bytes, sep -> character written after every value (e.g. '\n' or ',').
+ * Never writes past dest + cap and never writes a partial number: a value is
+ * written with its separator only if both fit. The output is not null
+ * terminated.
+ *
+ * A cap of at least 25 bytes (the longest number and its separator) always
+ * takes at least one value; below that a long number consumes nothing.
+ *
+ * Output:
+ * The number of values consumed, from the start of values. If len is not
+ * NULL, *len receives the number of written characters. Call again with the
+ * remaining values once dest has been drained.
+ *
+ * Exemplary usage:
+ *
+ * size_t done = 0;
+ * while (done < count) {
+ *      size_t len;
+ *      size_t n = fpconv_dtoa_many(values + done, count - done, buf, sizeof(buf), '\n', &len);
+ *      if (n == 0)
+ *          break; // buf is smaller than 25 bytes
+ *      fwrite(buf, 1, len, stdout);
+ *      done += n;
+ * }
+ *
+ */
+
+size_t fpconv_dtoa_many(const double* values, size_t count, char* dest, size_t cap, char sep, size_t* len);
+
 #endif
 
 /* [1] http://florian.loitsch.com/publications/dtoa-pldi2010.pdf */
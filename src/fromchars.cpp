@@ -0,0 +1,17 @@
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+
+#if __cpp_lib_to_chars >= 201611L
+
+#include "test.h"
+
+double atod_from_chars(const char* str) {
+	double value = 0.0;
+	std::from_chars(str, str + strlen(str), value);
+	return value;
+}
+
+REGISTER_ATOD_TEST(from_chars);
+
+#endif
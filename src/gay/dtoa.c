@@ -1,4 +1,11 @@
 #define IEEE_8087
+/* Renamed so that it does not replace the C library's strtod in the benchmark. */
+#define strtod gay_strtod
+/* Long must be 32 bits, which long is not on LP64 platforms. */
+#define Long int
+/* Per-thread Bigint pools, so that dtoa and strtod are reentrant without */
+/* MULTIPLE_THREADS locks serializing the threads. See Thread_Local_Pools. */
+#define Thread_Local_Pools
 
 /****************************************************************
  *
@@ -129,6 +136,13 @@
  *	all dtoa conversions in single-threaded executions with 8-byte
  *	pointers, PRIVATE_MEM >= 7400 appears to suffice; with 4-byte
  *	pointers, PRIVATE_MEM >= 7112 appears adequate.
+ * #define Thread_Local_Pools to give each thread its own freelist,
+ *	private memory and cached powers of 5, so that dtoa and strtod
+ *	can run in several threads at once without MULTIPLE_THREADS
+ *	locks. The private memory then defaults to 7400 bytes per
+ *	thread, enough to avoid MALLOC in all dtoa conversions, and
+ *	reset_dtoa_pool() returns the calling thread's pool to its
+ *	initial state in one step.
  * #define NO_INFNAN_CHECK if you do not wish to have INFNAN_CHECK
  *	#defined automatically on IEEE systems.  On such systems,
  *	when INFNAN_CHECK is #defined, strtod checks
@@ -223,13 +237,34 @@ extern void *MALLOC(size_t);
 #define MALLOC malloc
 #endif
 
+#ifdef Thread_Local_Pools
+#ifdef _MSC_VER
+#define Pool_Local __declspec(thread)
+#elif __STDC_VERSION__ >= 201112L
+#define Pool_Local _Thread_local
+#else
+#define Pool_Local __thread
+#endif
+#ifndef PRIVATE_MEM
+#define PRIVATE_MEM 7400
+#endif
+#else
+#define Pool_Local /*nothing*/
+#endif
+
 #ifndef Omit_Private_Memory
 #ifndef PRIVATE_MEM
 #define PRIVATE_MEM 2304
 #endif
 #define PRIVATE_mem ((PRIVATE_MEM+sizeof(double)-1)/sizeof(double))
+#ifdef Thread_Local_Pools
+/* The address of thread-local memory is not a constant; */
+/* pmem_next == 0 stands for private_mem. */
+static Pool_Local double private_mem[PRIVATE_mem], *pmem_next;
+#else
 static double private_mem[PRIVATE_mem], *pmem_next = private_mem;
 #endif
+#endif
 
 #undef IEEE_Arith
 #undef Avoid_Underflow
@@ -540,7 +575,7 @@ Bigint {
 
  typedef struct Bigint Bigint;
 
- static Bigint *freelist[Kmax+1];
+ static Pool_Local Bigint *freelist[Kmax+1];
 
  static Bigint *
 Balloc
@@ -568,6 +603,10 @@ Balloc
 #else
 		len = (sizeof(Bigint) + (x-1)*sizeof(ULong) + sizeof(double) - 1)
 			/sizeof(double);
+#ifdef Thread_Local_Pools
+		if (!pmem_next)
+			pmem_next = private_mem;
+#endif
 		if (k <= Kmax && pmem_next - private_mem + len <= PRIVATE_mem) {
 			rv = (Bigint*)pmem_next;
 			pmem_next += len;
@@ -913,7 +952,7 @@ mult
 	return c;
 	}
 
- static Bigint *p5s;
+ static Pool_Local Bigint *p5s;
 
  static Bigint *
 pow5mult
@@ -3560,7 +3599,7 @@ strtod
 	}
 
 #ifndef MULTIPLE_THREADS
- static char *dtoa_result;
+ static Pool_Local char *dtoa_result;
 #endif
 
  static char *
@@ -3624,6 +3663,59 @@ freedtoa(char *s)
 #endif
 	}
 
+#ifdef Thread_Local_Pools
+ static void
+#ifdef KR_headers
+pool_free(v) Bigint *v;
+#else
+pool_free(Bigint *v)
+#endif
+{
+#ifndef Omit_Private_Memory
+	if ((double*)v >= private_mem && (double*)v < private_mem + PRIVATE_mem)
+		return;
+#endif
+#ifdef FREE
+	FREE((void*)v);
+#else
+	free((void*)v);
+#endif
+	}
+
+/* reset_dtoa_pool() returns the calling thread's Bigint pool to its
+ * initial state: blocks on the freelists and the cached powers of 5
+ * that came from MALLOC are freed, and the private memory is rewound
+ * in one step. Strings returned by dtoa and not yet passed to freedtoa
+ * must not be used afterwards.
+ */
+
+ void
+reset_dtoa_pool(void)
+{
+	Bigint *b, *next;
+	int k;
+
+	for(k = 0; k <= Kmax; k++) {
+		for(b = freelist[k]; b; b = next) {
+			next = b->next;
+			pool_free(b);
+			}
+		freelist[k] = 0;
+		}
+	for(b = p5s; b; b = next) {
+		next = b->next;
+		pool_free(b);
+		}
+	p5s = 0;
+#ifndef MULTIPLE_THREADS
+	dtoa_result = 0;
+#endif
+#ifndef Omit_Private_Memory
+	pmem_next = 0;
+#endif
+	}
+#endif /* Thread_Local_Pools */
+
 /* dtoa for IEEE arithmetic (dmg): convert double to ASCII string.
  *
  * Inspired by "How to Print Floating-Point Numbers Accurately" by
@@ -1,11 +1,67 @@
 #include "test.h"
+#include "milo/dtoa_milo.h"
+#include "fixedformat.h"
 
 extern "C" {
-char *g_fmt(char *, double);
+char *dtoa(double, int, int, int *, int *, char **);
+void freedtoa(char *);
+void reset_dtoa_pool(void);
+double gay_strtod(const char *, char **);
 }
 
+// Shortest digits from dtoa() mode 0, written in milo's output format.
 void dtoa_gay(double value, char* buffer) {
-	g_fmt(buffer, value);
+	if (value == 0) {
+		buffer[0] = '0';
+		Prettify<JavaScriptFormat>(buffer, 1, 0);
+		return;
+	}
+
+	int decpt, sign;
+	char* end;
+	char* digits = dtoa(value, 0, 0, &decpt, &sign, &end);
+	if (sign)
+		*buffer++ = '-';
+	int length = static_cast<int>(end - digits);
+	memcpy(buffer, digits, length);
+	freedtoa(digits);
+	Prettify<JavaScriptFormat>(buffer, length, decpt - length);
+}
+
+// Correctly rounded digits from dtoa() mode 3, which takes the number of
+// digits after the decimal point.
+void fixed_gay(double value, int precision, char* buffer) {
+	int decpt, sign;
+	char* end;
+	char* digits = dtoa(value, 3, precision, &decpt, &sign, &end);
+	if (sign)
+		*buffer++ = '-';
+	FormatFixed(digits, static_cast<int>(end - digits), decpt, precision, buffer);
+	freedtoa(digits);
+}
+
+// digits correctly rounded significant digits from dtoa() mode 2, which strips
+// trailing zeros, padded back and written in milo's PrintfEFormat.
+void exponential_gay(double value, int digits, char* buffer) {
+	int decpt, sign;
+	char* end;
+	char* result = dtoa(value, 2, digits, &decpt, &sign, &end);
+	if (sign)
+		*buffer++ = '-';
+	int length = static_cast<int>(end - result);
+	memcpy(buffer, result, length);
+	freedtoa(result);
+	for (; length < digits; length++)
+		buffer[length] = '0';
+	Prettify<PrintfEFormat>(buffer, length, decpt - length);
+}
+
+double atod_gay(const char* str) {
+	return gay_strtod(str, 0);
 }
 
-//REGISTER_TEST(gay);
+// Gay's Bigint pools are per thread; benchmark threads release theirs on exit.
+REGISTER_TEST_THREAD_EXIT(gay, reset_dtoa_pool);
+REGISTER_ATOD_TEST(gay);
+REGISTER_FIXED_TEST(gay);
+REGISTER_EXPONENTIAL_TEST(gay);
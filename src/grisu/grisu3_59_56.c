@@ -0,0 +1,132 @@
+/*
+  Copyright (c) 2009 Florian Loitsch
+
+  Permission is hereby granted, free of charge, to any person
+  obtaining a copy of this software and associated documentation
+  files (the "Software"), to deal in the Software without
+  restriction, including without limitation the rights to use,
+  copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following
+  conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+  OTHER DEALINGS IN THE SOFTWARE.
+  */
+#include "diy_fp.h"
+#include "k_comp.h"
+#include "double.h"
+#include "powers.h"
+#include "prettify.h"
+#include <stdbool.h>
+#include <string.h>
+
+/* Gay's dtoa() (src/gay), the exact fallback for the rare values Grisu3
+ * rejects. */
+char* dtoa(double d, int mode, int ndigits, int* decpt, int* sign, char** rve);
+void freedtoa(char* s);
+
+#define TEN9 1000000000
+
+/* rest is the distance from the generated digits to too_high, wp_W the
+ * distance from W to too_high, each uncertain by ulp. Moves the last digit
+ * towards W like grisu_round, then rejects the result unless it is the
+ * closest one and certainly inside the interval. */
+static bool round_weed(char* buffer, int len,
+		       uint64_t wp_W, uint64_t Delta,
+		       uint64_t rest, uint64_t ten_kappa,
+		       uint64_t ulp) {
+  uint64_t wp_Wup = wp_W - ulp;
+  uint64_t wp_Wdown = wp_W + ulp;
+  while (rest < wp_Wup && /// round1
+	 Delta - rest >= ten_kappa &&
+	 (rest + ten_kappa < wp_Wup || /// closer
+	  wp_Wup - rest >= rest + ten_kappa - wp_Wup))
+  {
+    buffer[len-1]--; rest += ten_kappa;
+  }
+  if (rest < wp_Wdown && /// round2
+      Delta - rest >= ten_kappa &&
+      (rest + ten_kappa < wp_Wdown ||
+       wp_Wdown - rest > rest + ten_kappa - wp_Wdown)) return 0;
+  return 2*ulp <= rest && rest <= Delta - 4*ulp; /// weed
+}
+
+static bool digit_gen(diy_fp_t Wm, diy_fp_t W, diy_fp_t Wp,
+		      char* buffer, int* len, int* K) {
+  uint32_t div; int d,kappa; diy_fp_t one, wp_W, too_low, too_high, Delta;
+  uint64_t unit = 1;
+  too_low.f = Wm.f - unit; too_low.e = Wm.e;
+  too_high.f = Wp.f + unit; too_high.e = Wp.e;
+  Delta = minus(too_high, too_low);
+  wp_W = minus(too_high, W);
+  one.f = ((uint64_t) 1) << -W.e; one.e = W.e;
+  uint32_t p1 = too_high.f >> -one.e;
+  uint64_t p2 = too_high.f & (one.f - 1);
+  *len = 0; kappa = 10; div = TEN9;
+  while (kappa > 0) {
+    d = p1 / div;
+    if (d || *len) buffer[(*len)++] = '0' + d;
+    p1 %= div; kappa--;
+    uint64_t tmp = (((uint64_t)p1)<<-one.e)+p2;
+    if (tmp < Delta.f) {
+      *K += kappa;
+      return round_weed(buffer, *len, wp_W.f, Delta.f, tmp,
+			((uint64_t)div) << -one.e, unit);
+    }
+    div /= 10;
+  }
+  while (1) {
+    p2 *= 10; Delta.f *= 10; unit *= 10;
+    d = p2 >> -one.e;
+    if (d || *len) buffer[(*len)++] = '0' + d;
+    p2 &= one.f - 1; kappa--;
+    if (p2 < Delta.f) {
+      *K += kappa;
+      return round_weed(buffer, *len, wp_W.f * unit, Delta.f, p2,
+			one.f, unit);
+    }
+  }
+}
+
+/* Shortest digits of v > 0, or false if they cannot be guaranteed (about
+ * 0.5% of random doubles). */
+bool grisu3(double v, char* buffer, int* length, int* K) {
+  diy_fp_t w_m, w_p;
+  int q = 64, alpha = -59, gamma = -56;
+  normalized_boundaries(v, &w_m, &w_p);
+  diy_fp_t w = normalize_diy_fp(double2diy_fp(v));
+  int mk = k_comp(w_p.e + q, alpha, gamma);
+  diy_fp_t c_mk = cached_power(mk);
+  diy_fp_t W  = multiply(w,   c_mk);
+  diy_fp_t Wp = multiply(w_p, c_mk);
+  diy_fp_t Wm = multiply(w_m, c_mk);
+  *K = -mk;
+  return digit_gen(Wm, W, Wp, buffer, length, K);
+}
+
+/* Like fill_double, but always shortest: values Grisu3 rejects take Gay's
+ * dtoa() mode 0. */
+bool fill_double_grisu3(double v, char* buffer) {
+  int length, K;
+  if (!grisu3(v, buffer, &length, &K)) {
+    int decpt, sign;
+    char* end;
+    char* digits = dtoa(v, 0, 0, &decpt, &sign, &end);
+    length = end - digits;
+    memcpy(buffer, digits, length);
+    freedtoa(digits);
+    K = decpt - length;
+  }
+  prettify_string(buffer, 0, length, K);
+  return 1;
+}
@@ -2,6 +2,7 @@
 
 extern "C" {
 bool fill_double(double v, char* buffer);
+bool fill_double_grisu3(double v, char* buffer);
 }
 
 void dtoa_grisu2(double value, char* buffer) {
@@ -16,4 +17,17 @@ void dtoa_grisu2(double value, char* buffer) {
 	}
 }
 
+void dtoa_grisu3(double value, char* buffer) {
+	if (value == 0)
+		strcpy(buffer, "0.0");
+	else {
+		if (value < 0) {
+			*buffer++ = '-';
+			value = -value;
+		}
+		fill_double_grisu3(value, buffer);
+	}
+}
+
 REGISTER_TEST(grisu2);
+REGISTER_TEST(grisu3);
@@ -0,0 +1,11 @@
+#include <sstream>
+#include "test.h"
+
+double atod_istringstream(const char* str) {
+	std::istringstream iss(str);
+	double value = 0.0;
+	iss >> value;
+	return value;
+}
+
+REGISTER_ATOD_TEST(istringstream);
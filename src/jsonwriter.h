@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Minimal JSON writer for arrays and objects of numbers, in the spirit of
+// RapidJSON's Writer. Numbers are formatted by a registered dtoa. Keys are
+// written verbatim, so they must not need escaping. The output buffer starts
+// small and doubles when full, so growth is part of the measured cost.
+// Containers nest at most kMaxLevel - 1 deep; running out of memory aborts.
+class JsonWriter {
+public:
+	explicit JsonWriter(void(*dtoa)(double, char*), size_t initialCapacity = 256) :
+		mDtoa(dtoa),
+		mBuffer(static_cast<char*>(CheckAlloc(malloc(initialCapacity)))),
+		mEnd(mBuffer + initialCapacity),
+		mCursor(mBuffer),
+		mLevel(0),
+		mAfterKey(false)
+	{
+		mHasValue[0] = false;
+	}
+
+	~JsonWriter() {
+		free(mBuffer);
+	}
+
+	void StartArray() {
+		Prefix();
+		Put('[');
+		Push();
+	}
+
+	void EndArray() {
+		Pop();
+		Put(']');
+	}
+
+	void StartObject() {
+		Prefix();
+		Put('{');
+		Push();
+	}
+
+	void EndObject() {
+		Pop();
+		Put('}');
+	}
+
+	// Writes "key": and makes the next value belong to it.
+	void Key(const char* key, size_t length) {
+		Prefix();
+		Reserve(length + 3);
+		*mCursor++ = '"';
+		memcpy(mCursor, key, length);
+		mCursor += length;
+		*mCursor++ = '"';
+		*mCursor++ = ':';
+		mAfterKey = true;
+	}
+
+	void Double(double d) {
+		Prefix();
+		Reserve(kMaxNumberLength);
+		*mCursor = '\0';	// null writes nothing
+		mDtoa(d, mCursor);
+		mCursor += strlen(mCursor);
+	}
+
+	const char* GetString() const { return mBuffer; }
+	size_t GetSize() const { return static_cast<size_t>(mCursor - mBuffer); }
+
+private:
+	JsonWriter(const JsonWriter&);
+	JsonWriter& operator=(const JsonWriter&);
+
+	static const size_t kMaxNumberLength = 64;
+	static const int kMaxLevel = 32;
+
+	// Emits the separator before a value: none after a key or at the start of
+	// a container, ',' otherwise.
+	void Prefix() {
+		if (mAfterKey)
+			mAfterKey = false;
+		else if (mHasValue[mLevel])
+			Put(',');
+		mHasValue[mLevel] = true;
+	}
+
+	static void* CheckAlloc(void* p) {
+		if (!p) {
+			fprintf(stderr, "JsonWriter: out of memory\n");
+			abort();
+		}
+		return p;
+	}
+
+	void Push() {
+		assert(mLevel < kMaxLevel - 1);
+		mLevel++;
+		mHasValue[mLevel] = false;
+	}
+
+	void Pop() {
+		assert(mLevel > 0);
+		mLevel--;
+	}
+
+	void Put(char c) {
+		Reserve(1);
+		*mCursor++ = c;
+	}
+
+	void Reserve(size_t count) {
+		if (static_cast<size_t>(mEnd - mCursor) < count) {
+			size_t size = GetSize();
+			size_t capacity = static_cast<size_t>(mEnd - mBuffer) * 2;
+			while (capacity < size + count)
+				capacity *= 2;
+			mBuffer = static_cast<char*>(CheckAlloc(realloc(mBuffer, capacity)));
+			mEnd = mBuffer + capacity;
+			mCursor = mBuffer + size;
+		}
+	}
+
+	void(*mDtoa)(double, char*);
+	char* mBuffer;
+	char* mEnd;
+	char* mCursor;
+	int mLevel;
+	bool mAfterKey;
+	bool mHasValue[kMaxLevel];
+};
@@ -0,0 +1,46 @@
+// Body of one ISA build of the libdtoa kernel, included once by each
+// kernel_<isa>.cpp after defining:
+//   LIBDTOA_KERNEL_NAME  name of the exported function
+//   LIBDTOA_KERNEL_TARGET  target attribute string, for GCC and Clang
+// No include guard: every translation unit compiles its own copy.
+// Each target string also turns off the extensions the kernel's ISA level does
+// not include, so build flags such as -march=native do not leak into it.
+
+// Include what milo needs outside the namespace below, so that its own
+// includes are no-ops there.
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#if defined(_MSC_VER)
+#include "msinttypes/stdint.h"
+#include <intrin.h>
+#else
+#include <stdint.h>
+#endif
+
+// Clang ignores #pragma GCC target, so it gets the target attribute on every
+// function up to the end of the file instead.
+#if defined(LIBDTOA_KERNEL_TARGET)
+// #pragma does not expand macros; _Pragma takes the expanded string.
+#define LIBDTOA_PRAGMA(x) _Pragma(#x)
+#if defined(__clang__)
+#define LIBDTOA_TARGET_PRAGMA(isa) LIBDTOA_PRAGMA(clang attribute push(__attribute__((target(isa))), apply_to = function))
+#else
+#define LIBDTOA_TARGET_PRAGMA(isa) LIBDTOA_PRAGMA(GCC target(isa))
+#endif
+LIBDTOA_TARGET_PRAGMA(LIBDTOA_KERNEL_TARGET)
+#endif
+
+// Internal linkage, so that the inline functions of different ISA builds are
+// not merged by the linker.
+namespace {
+#include "milo/dtoa_milo.h"
+}
+
+extern "C" void LIBDTOA_KERNEL_NAME(double value, char* buffer) {
+	dtoa_milo(value, buffer);
+}
+
+#if defined(LIBDTOA_KERNEL_TARGET) && defined(__clang__)
+#pragma clang attribute pop
+#endif
@@ -0,0 +1,5 @@
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LIBDTOA_KERNEL_NAME libdtoa_kernel_avx2
+#define LIBDTOA_KERNEL_TARGET "avx2,bmi,bmi2,fma,popcnt,no-avx512f,no-lzcnt,no-movbe"
+#include "kernel.h"
+#endif
@@ -0,0 +1,5 @@
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LIBDTOA_KERNEL_NAME libdtoa_kernel_avx512
+#define LIBDTOA_KERNEL_TARGET "avx512f,avx512bw,avx512dq,avx512vl,avx2,bmi,bmi2,fma,popcnt,no-lzcnt,no-movbe"
+#include "kernel.h"
+#endif
@@ -0,0 +1,8 @@
+#define LIBDTOA_KERNEL_NAME libdtoa_kernel_scalar
+#if defined(__GNUC__) && defined(__x86_64__)
+// Back to the x86-64 baseline whatever the build flags (-msse4.2,
+// -march=native) enable. Turning off SSE3 turns off everything built on it up
+// to AVX-512; the scalar extensions are turned off one by one.
+#define LIBDTOA_KERNEL_TARGET "arch=x86-64,no-sse3,no-ssse3,no-sse4.1,no-sse4.2,no-avx,no-avx2,no-avx512f,no-fma,no-popcnt,no-bmi,no-bmi2,no-lzcnt,no-movbe"
+#endif
+#include "kernel.h"
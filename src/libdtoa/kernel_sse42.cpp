@@ -0,0 +1,5 @@
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LIBDTOA_KERNEL_NAME libdtoa_kernel_sse42
+#define LIBDTOA_KERNEL_TARGET "sse4.2,popcnt,no-avx,no-bmi,no-bmi2,no-lzcnt,no-movbe"
+#include "kernel.h"
+#endif
@@ -0,0 +1,126 @@
+#include "libdtoa.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LIBDTOA_X86 1
+#endif
+
+extern "C" {
+void libdtoa_kernel_scalar(double value, char* buffer);
+#if LIBDTOA_X86
+void libdtoa_kernel_sse42(double value, char* buffer);
+void libdtoa_kernel_avx2(double value, char* buffer);
+void libdtoa_kernel_avx512(double value, char* buffer);
+#endif
+}
+
+static const char* const kIsaNames[LIBDTOA_ISA_COUNT] = { "scalar", "sse42", "avx2", "avx512" };
+
+static const libdtoa_func kKernels[LIBDTOA_ISA_COUNT] = {
+	libdtoa_kernel_scalar,
+#if LIBDTOA_X86
+	libdtoa_kernel_sse42,
+	libdtoa_kernel_avx2,
+	libdtoa_kernel_avx512
+#else
+	0, 0, 0
+#endif
+};
+
+// cpuid through libgcc's __builtin_cpu_supports(), which also checks that the
+// OS saves the AVX and AVX-512 register state (XGETBV).
+static bool CpuSupports(libdtoa_isa isa) {
+#if LIBDTOA_X86
+	__builtin_cpu_init();	// may run before libgcc's own constructor
+	switch (isa) {
+	case LIBDTOA_ISA_SCALAR:
+		return true;
+	case LIBDTOA_ISA_SSE42:
+		return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+	case LIBDTOA_ISA_AVX2:
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") &&
+			__builtin_cpu_supports("bmi2") && __builtin_cpu_supports("fma") &&
+			CpuSupports(LIBDTOA_ISA_SSE42);
+	case LIBDTOA_ISA_AVX512:
+		return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+			__builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl") &&
+			CpuSupports(LIBDTOA_ISA_AVX2);
+	default:
+		return false;
+	}
+#else
+	return isa == LIBDTOA_ISA_SCALAR;
+#endif
+}
+
+// The best supported ISA, unless LIBDTOA_ISA names a supported one.
+static libdtoa_isa Select() {
+	const char* name = getenv("LIBDTOA_ISA");
+	if (name)
+		for (int isa = 0; isa < LIBDTOA_ISA_COUNT; isa++)
+			if (strcmp(name, kIsaNames[isa]) == 0 && libdtoa_supported(libdtoa_isa(isa)))
+				return libdtoa_isa(isa);
+
+	for (int isa = LIBDTOA_ISA_COUNT - 1; isa > LIBDTOA_ISA_SCALAR; isa--)
+		if (libdtoa_supported(libdtoa_isa(isa)))
+			return libdtoa_isa(isa);
+	return LIBDTOA_ISA_SCALAR;
+}
+
+static void Resolve(double value, char* buffer);
+
+// Constant initialized, so libdtoa_dtoa() works even from static
+// constructors that run before gInit below.
+static libdtoa_isa gSelected = LIBDTOA_ISA_SCALAR;
+static libdtoa_func gDtoa = Resolve;
+
+// Picks the kernel and replaces itself in gDtoa, so every later call costs
+// one indirect call.
+static void Resolve(double value, char* buffer) {
+	libdtoa_selected();
+	gDtoa(value, buffer);
+}
+
+// Resolves at load time, before any thread can race on gDtoa.
+static struct Init {
+	Init() {
+		libdtoa_selected();
+	}
+} gInit;
+
+extern "C" {
+
+void libdtoa_dtoa(double value, char* buffer) {
+	gDtoa(value, buffer);
+}
+
+int libdtoa_supported(libdtoa_isa isa) {
+	return isa >= 0 && isa < LIBDTOA_ISA_COUNT && kKernels[isa] && CpuSupports(isa);
+}
+
+libdtoa_func libdtoa_kernel(libdtoa_isa isa) {
+	return libdtoa_supported(isa) ? kKernels[isa] : 0;
+}
+
+int libdtoa_force(libdtoa_isa isa) {
+	if (!libdtoa_supported(isa))
+		return 0;
+	gSelected = isa;
+	gDtoa = kKernels[isa];
+	return 1;
+}
+
+libdtoa_isa libdtoa_selected(void) {
+	if (gDtoa == Resolve) {
+		gSelected = Select();
+		gDtoa = kKernels[gSelected];
+	}
+	return gSelected;
+}
+
+const char* libdtoa_isa_name(libdtoa_isa isa) {
+	return isa >= 0 && isa < LIBDTOA_ISA_COUNT ? kIsaNames[isa] : "unknown";
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// libdtoa: one shortest double-to-string entry point that runs the build of
+// the kernel (milo's Grisu2) compiled for the best instruction set the CPU
+// supports. The kernel is compiled once per ISA; the choice is made by cpuid
+// on first use and can be overridden with the LIBDTOA_ISA environment
+// variable (scalar, sse42, avx2 or avx512) or libdtoa_force().
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+	LIBDTOA_ISA_SCALAR,	// x86-64 baseline (SSE2), or the build's default elsewhere
+	LIBDTOA_ISA_SSE42,
+	LIBDTOA_ISA_AVX2,	// with BMI1/2 and FMA
+	LIBDTOA_ISA_AVX512,	// F, BW, DQ and VL
+	LIBDTOA_ISA_COUNT
+} libdtoa_isa;
+
+typedef void (*libdtoa_func)(double value, char* buffer);
+
+// Writes the shortest representation of value, null terminated, in milo's
+// format. buffer must hold at least 26 characters.
+void libdtoa_dtoa(double value, char* buffer);
+
+// Whether this build has a kernel for isa and the CPU and OS can run it.
+int libdtoa_supported(libdtoa_isa isa);
+
+// The kernel for isa, or null if it is not supported. For calling one
+// variant directly, without dispatch.
+libdtoa_func libdtoa_kernel(libdtoa_isa isa);
+
+// Makes libdtoa_dtoa() use isa. Returns 0, changing nothing, if isa is not
+// supported.
+int libdtoa_force(libdtoa_isa isa);
+
+// The ISA libdtoa_dtoa() currently uses.
+libdtoa_isa libdtoa_selected(void);
+
+// "scalar", "sse42", "avx2" or "avx512".
+const char* libdtoa_isa_name(libdtoa_isa isa);
+
+#ifdef __cplusplus
+}
+#endif
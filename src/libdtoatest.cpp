@@ -0,0 +1,22 @@
+#include "test.h"
+#include "libdtoa/libdtoa.h"
+
+// The facade, through its dispatch pointer.
+void dtoa_libdtoa(double value, char* buffer) {
+	libdtoa_dtoa(value, buffer);
+}
+
+REGISTER_TEST(libdtoa);
+
+// Every ISA build called directly, registered only where the CPU runs it, so
+// the variants can be compared with each other and with the dispatched call.
+static struct RegisterLibdtoaKernels {
+	RegisterLibdtoaKernels() {
+		static const char* const kNames[LIBDTOA_ISA_COUNT] = {
+			"libdtoa_scalar", "libdtoa_sse42", "libdtoa_avx2", "libdtoa_avx512"
+		};
+		for (int isa = 0; isa < LIBDTOA_ISA_COUNT; isa++)
+			if (libdtoa_func f = libdtoa_kernel(libdtoa_isa(isa)))
+				new Test(kNames[isa], f);	// lives as long as the registry
+	}
+} gRegisterLibdtoaKernels;
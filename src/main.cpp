@@ -1,9 +1,11 @@
 #include <algorithm>
 #include <cassert>
+#include <cstdarg>
 #include <cstdio>
 #include <cstring>
 #include <exception>
 #include <limits>
+#include <string>
 #if _MSC_VER
 #include "msinttypes/stdint.h"
 #else
@@ -14,7 +16,27 @@
 #include "resultfilename.h"
 #include "timer.h"
 #include "test.h"
+#include "alloccounter.h"
 #include "double-conversion/double-conversion.h"
+#include "double-conversion/dtoa-stats.h"
+#include "double-conversion/fast-dtoa.h"
+#include "double-conversion/bignum-dtoa.h"
+#include "double-conversion/ieee.h"
+#include "fixedformat.h"
+#include "libdtoa/libdtoa.h"
+extern "C" {
+#include "fpconv/fpconv.h"
+}
+#include "jsonwriter.h"
+#include "pipeline.h"
+#include "stb_sprintf/stb_sprintf.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
 
 const unsigned kVerifyRandomCount = 100000;
 const unsigned kIterationForRandom = 100;
@@ -34,12 +56,62 @@ private:
 	unsigned mSeed;
 };
 
+// Heap traffic and peak RSS of a measured section, written after the time as
+// the Allocs/op, Bytes/op and PeakRSS(KB) columns of a CSV row. Peak RSS is
+// restarted at construction where the platform supports it (Linux), otherwise
+// it is the high-water mark of the process so far.
+class MemoryProbe {
+public:
+	MemoryProbe() {
+		ResetPeakRss();
+		mStart = GetAllocationStats();
+	}
+
+	double GetAllocationsPerOp(double operations) const {
+		return (GetAllocationStats().count - mStart.count) / operations;
+	}
+
+	double GetBytesPerOp(double operations) const {
+		return (GetAllocationStats().bytes - mStart.bytes) / operations;
+	}
+
+	// Ends a CSV row.
+	void WriteColumns(FILE* fp, double operations) const {
+		AllocationStats stats = GetAllocationStats();
+		fprintf(fp, ",%f,%f,%u\n",
+			(stats.count - mStart.count) / operations,
+			(stats.bytes - mStart.bytes) / operations,
+			(unsigned)(GetPeakRss() >> 10));
+	}
+
+private:
+	AllocationStats mStart;
+};
+
+// Significant digits of a decimal string, without sign, point, exponent and
+// leading or trailing zeros: "0.10" and "1e-1" both give "1".
+static std::string SignificantDigits(const char* s) {
+	std::string digits;
+	for (; *s && *s != 'e' && *s != 'E'; s++)
+		if (*s >= '0' && *s <= '9' && (*s != '0' || !digits.empty()))
+			digits += *s;
+	digits.erase(digits.find_last_not_of('0') + 1);
+	return digits;
+}
+
+// The expected strings are in fixed layout. Formats that never use it (e.g.
+// milo_scientific) match when they have the same digits for the same value.
+static bool MatchExpect(const char* actual, const char* expect) {
+	return strcmp(actual, expect) == 0 ||
+		(SignificantDigits(actual) == SignificantDigits(expect) && strtod(actual, NULL) == strtod(expect, NULL));
+}
+
 static size_t VerifyValue(double value, void(*f)(double, char*), const char* expect = 0) {
 	char buffer[1024];
 	f(value, buffer);
 
 	//printf("%.17g -> %s\n", value, buffer);
-	if (expect && strcmp(buffer, expect) != 0) {
+	if (expect && !MatchExpect(buffer, expect)) {
 		printf("Error: expect %s but actual %s\n", expect, buffer);
 		//throw std::exception();
 	}
@@ -107,7 +179,126 @@ static void Verify(void(*f)(double, char*), const char* fname) {
 	}
 
 	double lenAvg = double(lenSum) / kVerifyRandomCount;
-	printf("OK. Length Avg = %2.3f, Max = %d\n", lenAvg, (int)lenMax);
+	printf("OK. Length Avg = %2.3f, Max = %d", lenAvg, (int)lenMax);
+
+	// Heap allocations per conversion, without the verification around it.
+	{
+		char buffer[1024];
+		MemoryProbe probe;
+		for (unsigned i = 0; i < kVerifyRandomCount; i++) {
+			u.u = uint64_t(r()) << 32;
+			u.u |= uint64_t(r());
+			if (!isnan(u.d) && !isinf(u.d))
+				f(u.d, buffer);
+		}
+		printf(", Allocs/op = %.3f, Bytes/op = %.1f", probe.GetAllocationsPerOp(kVerifyRandomCount), probe.GetBytesPerOp(kVerifyRandomCount));
+	}
+	printf("\n");
+}
+
+static size_t VerifyFloatValue(float value, void(*f)(float, char*), const char* expect = 0) {
+	char buffer[1024];
+	f(value, buffer);
+
+	if (expect && !MatchExpect(buffer, expect)) {
+		printf("Error: expect %s but actual %s\n", expect, buffer);
+	}
+
+	using namespace double_conversion;
+	StringToDoubleConverter converter(StringToDoubleConverter::ALLOW_TRAILING_JUNK, 0.0, 0.0, NULL, NULL);
+	int processed = 0;
+	float roundtrip = converter.StringToFloat(buffer, 1024, &processed);
+
+	size_t len = strlen(buffer);
+	if (len != (size_t)processed) {
+		printf("Error: some extra character %g -> '%s'\n", value, buffer);
+		throw std::exception();
+	}
+	if (value != roundtrip) {
+		printf("Error: roundtrip fail %.9g -> '%s' -> %.9g\n", value, buffer, roundtrip);
+	}
+
+	return len;
+}
+
+static void VerifyFloat(void(*f)(float, char*), const char* fname) {
+	printf("Verifying float %-20s ... ", fname);
+
+	// Boundary and simple cases
+	VerifyFloatValue(0, f);
+	VerifyFloatValue(0.1f, f, "0.1");
+	VerifyFloatValue(0.12f, f, "0.12");
+	VerifyFloatValue(0.123f, f, "0.123");
+	VerifyFloatValue(0.1234f, f, "0.1234");
+	VerifyFloatValue(1.2345f, f, "1.2345");
+	VerifyFloatValue(1.0f / 3.0f, f);
+	VerifyFloatValue(2.0f / 3.0f, f);
+	VerifyFloatValue(std::numeric_limits<float>::min(), f);
+	VerifyFloatValue(std::numeric_limits<float>::max(), f);
+	VerifyFloatValue(std::numeric_limits<float>::denorm_min(), f);
+
+	union {
+		float f;
+		uint32_t u;
+	}u;
+	Random r;
+
+	uint64_t lenSum = 0;
+	size_t lenMax = 0;
+	for (unsigned i = 0; i < kVerifyRandomCount; i++) {
+		do {
+			u.u = r();
+		} while (isnan(u.f) || isinf(u.f));
+		size_t len = VerifyFloatValue(u.f, f);
+		lenSum += len;
+		lenMax = std::max(lenMax, len);
+	}
+
+	double lenAvg = double(lenSum) / kVerifyRandomCount;
+	printf("OK. Length Avg = %2.3f, Max = %d", lenAvg, (int)lenMax);
+
+	{
+		char buffer[1024];
+		MemoryProbe probe;
+		for (unsigned i = 0; i < kVerifyRandomCount; i++) {
+			u.u = r();
+			if (!isnan(u.f) && !isinf(u.f))
+				f(u.f, buffer);
+		}
+		printf(", Allocs/op = %.3f, Bytes/op = %.1f", probe.GetAllocationsPerOp(kVerifyRandomCount), probe.GetBytesPerOp(kVerifyRandomCount));
+	}
+	printf("\n");
+}
+
+// Every positive finite float through f, checked by roundtrip. Negative values
+// differ only in the sign. Takes minutes, so it is not run by default.
+void ftoa_milo(float value, char* buffer);
+
+void VerifyFloatExhaustive(void(*f)(float, char*), const char* fname) {
+	printf("Verifying all floats %-14s ... ", fname);
+	fflush(stdout);
+
+	using namespace double_conversion;
+	StringToDoubleConverter converter(StringToDoubleConverter::ALLOW_TRAILING_JUNK, 0.0, 0.0, NULL, NULL);
+	union {
+		float f;
+		uint32_t u;
+	}u;
+	uint64_t failures = 0;
+	for (uint32_t bits = 0; bits < 0x7F800000; bits++) {
+		u.u = bits;
+		char buffer[64];
+		f(u.f, buffer);
+		int processed = 0;
+		float roundtrip = converter.StringToFloat(buffer, static_cast<int>(strlen(buffer)), &processed);
+		if (roundtrip != u.f && failures++ < 10)
+			printf("\nError: roundtrip fail %.9g -> '%s' -> %.9g", u.f, buffer, roundtrip);
+	}
+
+	if (failures)
+		printf("\n%u errors\n", (unsigned)failures);
+	else
+		printf("OK.\n");
 }
 
 void VerifyAll() {
@@ -122,6 +313,16 @@ void VerifyAll() {
 			}
 		}
 	}
+
+	const FloatTestList& floatTests = FloatTestManager::Instance().GetTests();
+
+	for (FloatTestList::const_iterator itr = floatTests.begin(); itr != floatTests.end(); ++itr) {
+		try {
+			VerifyFloat((*itr)->ftoa, (*itr)->fname);
+		}
+		catch (...) {
+		}
+	}
 }
 
 void BenchSequential(void(*f)(double, char*), const char* fname, FILE* fp) {
@@ -135,6 +336,7 @@ void BenchSequential(void(*f)(double, char*), const char* fname, FILE* fp) {
 	for (int digit = 1; digit <= 17; digit++) {
 		int64_t end = start * 10;
 
+		MemoryProbe probe;
 		double duration = std::numeric_limits<double>::max();
 		for (unsigned trial = 0; trial < kTrial; trial++) {
 			int64_t v = start;
@@ -159,7 +361,8 @@ void BenchSequential(void(*f)(double, char*), const char* fname, FILE* fp) {
 		duration *= 1e6 / kIterationPerDigit; // convert to nano second per operation
 		minDuration = std::min(minDuration, duration);
 		maxDuration = std::max(maxDuration, duration);
-		fprintf(fp, "%s_sequential,%d,%f\n", fname, digit, duration);
+		fprintf(fp, "sequential,%s,%d,%f", fname, digit, duration);
+		probe.WriteColumns(fp, kTrial * kIterationPerDigit);
 		start = end;
 	}
 
@@ -209,6 +412,7 @@ void BenchRandom(void(*f)(double, char*), const char* fname, FILE* fp) {
 	double* data = RandomData::GetData();
 	size_t n = RandomData::kCount;
 
+	MemoryProbe probe;
 	double duration = std::numeric_limits<double>::max();
 	for (unsigned trial = 0; trial < kTrial; trial++) {
 		Timer timer;
@@ -224,7 +428,8 @@ void BenchRandom(void(*f)(double, char*), const char* fname, FILE* fp) {
 
 	duration *= 1e6 / (kIterationForRandom * n); // convert to nano second per operation
 
-	fprintf(fp, "random,%s,0,%f\n", fname, duration);
+	fprintf(fp, "random,%s,0,%f", fname, duration);
+	probe.WriteColumns(fp, double(kTrial) * kIterationForRandom * n);
 
 	printf("%8.3fns\n", duration);
 }
@@ -290,6 +495,7 @@ void BenchRandomDigit(void(*f)(double, char*), const char* fname, FILE* fp) {
 		double* data = RandomDigitData::GetData(digit);
 		size_t n = RandomDigitData::kCount;
 
+		MemoryProbe probe;
 		double duration = std::numeric_limits<double>::max();
 		for (unsigned trial = 0; trial < kTrial; trial++) {
 			Timer timer;
@@ -310,46 +516,1814 @@ void BenchRandomDigit(void(*f)(double, char*), const char* fname, FILE* fp) {
 		duration *= 1e6 / (kIterationPerDigit * n); // convert to nano second per operation
 		minDuration = std::min(minDuration, duration);
 		maxDuration = std::max(maxDuration, duration);
-		fprintf(fp, "randomdigit,%s,%d,%f\n", fname, digit, duration);
+		fprintf(fp, "randomdigit,%s,%d,%f", fname, digit, duration);
+		probe.WriteColumns(fp, double(kTrial) * kIterationPerDigit * n);
 	}
 	printf("[%8.3fns, %8.3fns]\n", minDuration, maxDuration);
 }
 
-void Bench(void(*f)(double, char*), const char* fname, FILE* fp) {
-	//BenchSequential(f, fname, fp);
-	//BenchRandom(f, fname, fp);
-	BenchRandomDigit(f, fname, fp);
+// The values of RandomDigitData printed with "%.*g" and the same number of
+// digits, as input for string to double conversion.
+class RandomDigitStringData {
+public:
+	static const char* GetData(int digit) {
+		assert(digit >= 1 && digit <= RandomDigitData::kMaxDigit);
+		static RandomDigitStringData singleton;
+		return singleton.mData + (digit - 1) * kCount * kStride;
+	}
+
+	static const size_t kCount = RandomDigitData::kCount;
+	static const size_t kStride = 32;
+
+private:
+	RandomDigitStringData() :
+		mData(new char[RandomDigitData::kMaxDigit * kCount * kStride])
+	{
+		char* p = mData;
+		for (int digit = 1; digit <= RandomDigitData::kMaxDigit; digit++) {
+			double* data = RandomDigitData::GetData(digit);
+			for (size_t i = 0; i < kCount; i++, p += kStride)
+				sprintf(p, "%.*g", digit, data[i]);
+		}
+	}
+
+	~RandomDigitStringData() {
+		delete[] mData;
+	}
+
+	char* mData;
+};
+
+static bool VerifyAtodValue(const char* str, double expect, double(*f)(const char*)) {
+	double actual = f(str);
+	if (memcmp(&actual, &expect, sizeof(double)) != 0) {
+		printf("Error: '%s' expect %.17g but actual %.17g\n", str, expect, actual);
+		return false;
+	}
+	return true;
 }
 
-void BenchAll() {
-	// doublery to write to /result path, where template.php exists
-	FILE *fp;
-	if ((fp = fopen("../../result/template.php", "r")) != NULL) {
-		fclose(fp);
-		fp = fopen("../../result/" RESULT_FILENAME, "w");
+// Checks the parsed results bit by bit. The %.17g random strings and the
+// boundary cases have known exact results; the randomdigit corpora are
+// compared with the values RandomDigitData obtained from double-conversion's
+// exact (bignum backed) StringToDouble.
+static void VerifyAtod(double(*f)(const char*), const char* fname) {
+	printf("Verifying atod %-20s ... ", fname);
+
+	size_t errors = 0;
+
+	// Boundary and simple cases
+	errors += !VerifyAtodValue("0", 0.0, f);
+	errors += !VerifyAtodValue("-0", -0.0, f);
+	errors += !VerifyAtodValue("0.1", 0.1, f);
+	errors += !VerifyAtodValue("1.2345", 1.2345, f);
+	errors += !VerifyAtodValue("-1.5e-3", -1.5e-3, f);
+	errors += !VerifyAtodValue("9007199254740993", 9007199254740992.0, f);
+	errors += !VerifyAtodValue("2.2250738585072014e-308", std::numeric_limits<double>::min(), f);
+	errors += !VerifyAtodValue("1.7976931348623157e+308", std::numeric_limits<double>::max(), f);
+	errors += !VerifyAtodValue("4.9406564584124654e-324", std::numeric_limits<double>::denorm_min(), f);
+
+	union {
+		double d;
+		uint64_t u;
+	}u;
+	Random r;
+
+	for (unsigned i = 0; i < kVerifyRandomCount; i++) {
+		do {
+			// Need to call r() in two statements for cross-platform coherent sequence.
+			u.u = uint64_t(r()) << 32;
+			u.u |= uint64_t(r());
+		} while (isnan(u.d) || isinf(u.d));
+		char buffer[256];
+		sprintf(buffer, "%.17g", u.d);
+		errors += !VerifyAtodValue(buffer, u.d, f);
 	}
-	else if ((fp = fopen("../result/template.php", "r")) != NULL) {
-		fclose(fp);
-		fp = fopen("../result/" RESULT_FILENAME, "w");
+
+	for (int digit = 1; digit <= RandomDigitData::kMaxDigit; digit++) {
+		const double* expect = RandomDigitData::GetData(digit);
+		const char* data = RandomDigitStringData::GetData(digit);
+		for (size_t i = 0; i < RandomDigitStringData::kCount; i++)
+			errors += !VerifyAtodValue(data + i * RandomDigitStringData::kStride, expect[i], f);
 	}
+
+	if (errors == 0)
+		printf("OK.\n");
 	else
-		fp = fopen(RESULT_FILENAME, "w");
+		printf("%u errors.\n", (unsigned)errors);
+}
 
-	fprintf(fp, "Type,Function,Digit,Time(ns)\n");
+void VerifyAtodAll() {
+	const AtodTestList& atodTests = AtodTestManager::Instance().GetTests();
 
-	const TestList& tests = TestManager::Instance().GetTests();
+	for (AtodTestList::const_iterator itr = atodTests.begin(); itr != atodTests.end(); ++itr)
+		VerifyAtod((*itr)->atod, (*itr)->fname);
+}
 
-	for (TestList::const_iterator itr = tests.begin(); itr != tests.end(); ++itr)
-		Bench((*itr)->dtoa, (*itr)->fname, fp);
+void BenchAtodRandomDigit(double(*f)(const char*), const char* fname, FILE* fp) {
+	printf("Benchmarking atod_randomdigit %-20s ... ", fname);
 
-	fclose(fp);
+	double minDuration = std::numeric_limits<double>::max();
+	double maxDuration = 0.0;
+	double sum = 0.0;
+
+	for (int digit = 1; digit <= RandomDigitData::kMaxDigit; digit++) {
+		const char* data = RandomDigitStringData::GetData(digit);
+		size_t n = RandomDigitStringData::kCount;
+
+		MemoryProbe probe;
+		double duration = std::numeric_limits<double>::max();
+		for (unsigned trial = 0; trial < kTrial; trial++) {
+			Timer timer;
+			timer.Start();
+
+			for (unsigned iteration = 0; iteration < kIterationPerDigit; iteration++)
+				for (size_t i = 0; i < n; i++)
+					sum += f(data + i * RandomDigitStringData::kStride);
+
+			timer.Stop();
+			duration = std::min(duration, timer.GetElapsedMilliseconds());
+		}
+
+		duration *= 1e6 / (kIterationPerDigit * n); // convert to nano second per operation
+		minDuration = std::min(minDuration, duration);
+		maxDuration = std::max(maxDuration, duration);
+		fprintf(fp, "atod_randomdigit,%s,%d,%f", fname, digit, duration);
+		probe.WriteColumns(fp, double(kTrial) * kIterationPerDigit * n);
+	}
+	printf("[%8.3fns, %8.3fns]\n", minDuration, maxDuration);
+
+	// Keep the conversions from being optimized away.
+	if (sum == 0.0)
+		printf("\n");
 }
 
-int main() {
-	// sort tests
-	TestList& tests = TestManager::Instance().GetTests();
-	std::sort(tests.begin(), tests.end());
+void BenchAtod(double(*f)(const char*), const char* fname, FILE* fp) {
+	BenchAtodRandomDigit(f, fname, fp);
+}
+
+// Returns true if double-conversion's ToShortest gives up on Grisu3 for value
+// and takes the exact bignum path. With DOUBLE_CONVERSION_STATS the path is
+// read from the library's counters, otherwise FastDtoa is asked directly.
+static bool IsGrisu3Fallback(double value) {
+	using namespace double_conversion;
+	if (DtoaStatsEnabled()) {
+		DtoaStats before, after;
+		GetDtoaStats(&before);
+		char buffer[256];
+		StringBuilder sb(buffer, sizeof(buffer));
+		DoubleToStringConverter::EcmaScriptConverter().ToShortest(value, &sb);
+		GetDtoaStats(&after);
+		return after.grisu3_bailout != before.grisu3_bailout;
+	}
+	else {
+		char buffer[kFastDtoaMaximalLength + 1];
+		int length, point;
+		return !FastDtoa(fabs(value), FAST_DTOA_SHORTEST, 0, Vector<char>(buffer, kFastDtoaMaximalLength + 1), &length, &point);
+	}
+}
+
+// Random doubles split by the path double-conversion takes for them: Grisu3
+// alone, or Grisu3 bail-out followed by the exact bignum fallback. The latter
+// are the tail latency outliers of Grisu3-based implementations.
+class PathData {
+public:
+	static double* GetData(bool fallback) {
+		static PathData singleton;
+		return fallback ? singleton.mFallback : singleton.mGrisu3;
+	}
+
+	static const size_t kCount = 1000;
+
+private:
+	PathData() :
+		mGrisu3(new double[kCount]),
+		mFallback(new double[kCount])
+	{
+		Random r;
+		union {
+			double d;
+			uint64_t u;
+		}u;
+
+		size_t grisu3Count = 0, fallbackCount = 0, scanned = 0;
+		while (grisu3Count < kCount || fallbackCount < kCount) {
+			// Need to call r() in two statements for cross-platform coherent sequence.
+			u.u = uint64_t(r()) << 32;
+			u.u |= uint64_t(r());
+			if (isnan(u.d) || isinf(u.d) || u.d == 0.0)
+				continue;
+
+			scanned++;
+			if (IsGrisu3Fallback(u.d)) {
+				if (fallbackCount < kCount)
+					mFallback[fallbackCount++] = u.d;
+			}
+			else if (grisu3Count < kCount)
+				mGrisu3[grisu3Count++] = u.d;
+		}
+
+		printf("Scanned %u random doubles for %u Grisu3 fallbacks (%.3f%%)\n",
+			(unsigned)scanned, (unsigned)kCount, 100.0 * kCount / scanned);
+	}
+
+	~PathData() {
+		delete[] mGrisu3;
+		delete[] mFallback;
+	}
+
+	double* mGrisu3;
+	double* mFallback;
+};
+
+static double BenchPathData(void(*f)(double, char*), const char* fname, FILE* fp, const char* type, const double* data, size_t n) {
+	char buffer[256];
+	MemoryProbe probe;
+	double duration = std::numeric_limits<double>::max();
+	for (unsigned trial = 0; trial < kTrial; trial++) {
+		Timer timer;
+		timer.Start();
+
+		for (unsigned iteration = 0; iteration < kIterationPerDigit; iteration++)
+			for (size_t i = 0; i < n; i++)
+				f(data[i], buffer);
+
+		timer.Stop();
+		duration = std::min(duration, timer.GetElapsedMilliseconds());
+	}
+
+	duration *= 1e6 / (kIterationPerDigit * n); // convert to nano second per operation
+	fprintf(fp, "%s,%s,0,%f", type, fname, duration);
+	probe.WriteColumns(fp, double(kTrial) * kIterationPerDigit * n);
+	return duration;
+}
+
+void BenchPath(void(*f)(double, char*), const char* fname, FILE* fp) {
+	size_t n = PathData::kCount;
+	double* grisu3 = PathData::GetData(false);
+	double* fallback = PathData::GetData(true);
+
+	printf("Benchmarking        path %-20s ... ", fname);
+
+	double grisu3Duration = BenchPathData(f, fname, fp, "grisu3", grisu3, n);
+	double fallbackDuration = BenchPathData(f, fname, fp, "fallback", fallback, n);
+
+	printf("[%8.3fns, %8.3fns]\n", grisu3Duration, fallbackDuration);
+}
+
+// Cold-cache latency. In services a number is formatted between unrelated
+// work, which evicts the implementation's tables (kCachedPowers_F,
+// GetDigitsLut(), ...) and code from the caches. Here every conversion follows
+// a workload that reads kColdCacheSizes[i] KB of data and runs a code blob
+// larger than the L1 instruction cache, and only the conversion is timed.
+// Size 0 skips the workload, giving the warm latency by the same method. The
+// results have the index of the size + 1 as Digit.
+const unsigned kColdCacheSizes[] = { 0, 32, 256, 4096 };	// KB
+const unsigned kColdCodeFunctionCount = 256;
+
+#define COLD_CODE_ROUND(i) x = (x ^ (N * 2654435761u + i)) * 2246822519u; x ^= x >> 15;
+
+// Each instantiation mixes with its own constants, so none share code. 256 of
+// them make about 150KB of code with GCC -O2.
+template <unsigned N>
+static unsigned ColdCode(unsigned x) {
+	COLD_CODE_ROUND(1) COLD_CODE_ROUND(2) COLD_CODE_ROUND(3) COLD_CODE_ROUND(4)
+	COLD_CODE_ROUND(5) COLD_CODE_ROUND(6) COLD_CODE_ROUND(7) COLD_CODE_ROUND(8)
+	COLD_CODE_ROUND(9) COLD_CODE_ROUND(10) COLD_CODE_ROUND(11) COLD_CODE_ROUND(12)
+	COLD_CODE_ROUND(13) COLD_CODE_ROUND(14) COLD_CODE_ROUND(15) COLD_CODE_ROUND(16)
+	COLD_CODE_ROUND(17) COLD_CODE_ROUND(18) COLD_CODE_ROUND(19) COLD_CODE_ROUND(20)
+	COLD_CODE_ROUND(21) COLD_CODE_ROUND(22) COLD_CODE_ROUND(23) COLD_CODE_ROUND(24)
+	COLD_CODE_ROUND(25) COLD_CODE_ROUND(26) COLD_CODE_ROUND(27) COLD_CODE_ROUND(28)
+	COLD_CODE_ROUND(29) COLD_CODE_ROUND(30) COLD_CODE_ROUND(31) COLD_CODE_ROUND(32)
+	return x;
+}
+
+#undef COLD_CODE_ROUND
+
+typedef unsigned (*ColdCodeFunc)(unsigned);
+
+template <unsigned N>
+struct ColdCodeTable {
+	static void Fill(ColdCodeFunc* table) {
+		table[N - 1] = ColdCode<N - 1>;
+		ColdCodeTable<N - 1>::Fill(table);
+	}
+};
+
+template <>
+struct ColdCodeTable<0> {
+	static void Fill(ColdCodeFunc*) {}
+};
+
+class ColdCacheWorkload {
+public:
+	static ColdCacheWorkload& Instance() {
+		static ColdCacheWorkload singleton;
+		return singleton;
+	}
+
+	// Reads one byte per cache line of size KB of data, then calls every
+	// function of the code blob.
+	void Run(unsigned size) {
+		if (size == 0)
+			return;
+
+		unsigned sum = 0;
+		size_t end = size_t(size) << 10;
+		for (size_t i = 0; i < end; i += 64)
+			sum += mData[i];
+		for (unsigned i = 0; i < kColdCodeFunctionCount; i++)
+			sum = mCode[i](sum);
+		mSink = sum;
+	}
+
+private:
+	ColdCacheWorkload() : mData(new unsigned char[GetMaxSize() << 10]), mSink(0) {
+		memset(mData, 1, GetMaxSize() << 10);
+		ColdCodeTable<kColdCodeFunctionCount>::Fill(mCode);
+	}
+
+	~ColdCacheWorkload() {
+		delete[] mData;
+	}
+
+	static size_t GetMaxSize() {
+		size_t size = 0;
+		for (size_t i = 0; i < sizeof(kColdCacheSizes) / sizeof(kColdCacheSizes[0]); i++)
+			size = std::max(size, size_t(kColdCacheSizes[i]));
+		return size;
+	}
+
+	unsigned char* mData;
+	ColdCodeFunc mCode[kColdCodeFunctionCount];
+	volatile unsigned mSink;
+};
+
+// Stands in for the conversion to measure what the timer and the call cost.
+static void ColdCacheEmpty(double, char*) {
+}
+
+// Sum over the n values of the time of f alone after each workload pass, the
+// minimum of kTrial trials, in milliseconds.
+static double ColdCacheDuration(void(*f)(double, char*), unsigned size, const double* data, size_t n) {
+	ColdCacheWorkload& workload = ColdCacheWorkload::Instance();
+	char buffer[256];
+	double duration = std::numeric_limits<double>::max();
+	for (unsigned trial = 0; trial < kTrial; trial++) {
+		double sum = 0.0;
+		for (size_t i = 0; i < n; i++) {
+			workload.Run(size);
+
+			Timer timer;
+			timer.Start();
+			f(data[i], buffer);
+			timer.Stop();
+			sum += timer.GetElapsedMilliseconds();
+		}
+		duration = std::min(duration, sum);
+	}
+	return duration;
+}
+
+// Every call is timed on its own, so the Start()/Stop() pair is as long as a
+// fast conversion. It is measured with ColdCacheEmpty() after the same workload
+// and subtracted. On Windows QueryPerformanceCounter() ticks slower than one
+// call, so only the mean over the n calls means anything there.
+void BenchColdCache(void(*f)(double, char*), const char* fname, FILE* fp) {
+	printf("Benchmarking   coldcache %-20s ... ", fname);
+
+	double* data = RandomData::GetData();
+	size_t n = RandomData::kCount;
+
+	for (size_t s = 0; s < sizeof(kColdCacheSizes) / sizeof(kColdCacheSizes[0]); s++) {
+		unsigned size = kColdCacheSizes[s];
+		double overhead = ColdCacheDuration(ColdCacheEmpty, size, data, n);
+
+		MemoryProbe probe;
+		double duration = std::max(ColdCacheDuration(f, size, data, n) - overhead, 0.0);
+
+		duration *= 1e6 / n; // convert to nano second per operation
+		fprintf(fp, "coldcache,%s,%u,%f", fname, unsigned(s + 1), duration);
+		probe.WriteColumns(fp, double(kTrial) * n);
+		printf("%uKB %8.3fns ", size, duration);
+	}
+	printf("\n");
+}
+
+#ifndef _WIN32
+
+// End-to-end streaming: kStreamCount values, one per line, formatted into
+// chunked buffers and written to a temporary file.
+const size_t kStreamCount = 100000000;
+const size_t kStreamChunkSize = 1 << 20;
+const size_t kStreamChunkCount = 16;	// buffers per writev()
+const size_t kStreamMaxLength = 32;	// upper bound of one formatted line
+
+// A column of random doubles, cycled to generate the kStreamCount values.
+class StreamColumnData {
+public:
+	static double* GetData() {
+		static StreamColumnData singleton;
+		return singleton.mData;
+	}
+
+	static const size_t kCount = 1 << 20;
+
+private:
+	StreamColumnData() :
+		mData(new double[kCount])
+	{
+		Random r;
+		union {
+			double d;
+			uint64_t u;
+		}u;
+
+		for (size_t i = 0; i < kCount; i++) {
+			do {
+				// Need to call r() in two statements for cross-platform coherent sequence.
+				u.u = uint64_t(r()) << 32;
+				u.u |= uint64_t(r());
+			} while (isnan(u.d) || isinf(u.d));
+			mData[i] = u.d;
+		}
+	}
+
+	~StreamColumnData() {
+		delete[] mData;
+	}
+
+	double* mData;
+};
+
+struct StreamResult {
+	StreamResult() : bytes(), formatMs(), ioMs(), userMs(), systemMs() {}
+
+	uint64_t bytes;
+	double formatMs;
+	double ioMs;
+	double userMs;
+	double systemMs;
+};
+
+static double CpuMilliseconds(const struct timeval& tv) {
+	return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+static int OpenStreamFile() {
+	const char* dir = getenv("TMPDIR");
+	char path[1024];
+	snprintf(path, sizeof(path), "%s/dtoa-benchmark-XXXXXX", dir ? dir : "/tmp");
+	int fd = mkstemp(path);
+	if (fd < 0) {
+		perror("mkstemp");
+		throw std::exception();
+	}
+	unlink(path);
+	return fd;
+}
+
+// Formats values into buffer until it has less than kStreamMaxLength bytes
+// left or all values are done. Returns the number of bytes written.
+static size_t FormatStreamChunk(void(*f)(double, char*), const double* column, size_t& index, char* buffer, size_t size) {
+	char* p = buffer;
+	char* end = buffer + size - kStreamMaxLength;
+	while (p < end && index < kStreamCount) {
+		*p = '\0';	// null writes nothing
+		f(column[index % StreamColumnData::kCount], p);
+		p += strlen(p);
+		*p++ = '\n';
+		index++;
+	}
+	return p - buffer;
+}
+
+static void StreamWrite(void(*f)(double, char*), int fd, StreamResult& result) {
+	const double* column = StreamColumnData::GetData();
+	char* buffer = new char[kStreamChunkSize];
+	size_t index = 0;
+	Timer timer;
+	while (index < kStreamCount) {
+		timer.Start();
+		size_t length = FormatStreamChunk(f, column, index, buffer, kStreamChunkSize);
+		timer.Stop();
+		result.formatMs += timer.GetElapsedMilliseconds();
+
+		timer.Start();
+		if (write(fd, buffer, length) != (ssize_t)length) {
+			perror("write");
+			throw std::exception();
+		}
+		timer.Stop();
+		result.ioMs += timer.GetElapsedMilliseconds();
+		result.bytes += length;
+	}
+	delete[] buffer;
+}
+
+static void StreamWritev(void(*f)(double, char*), int fd, StreamResult& result) {
+	const double* column = StreamColumnData::GetData();
+	char* buffer = new char[kStreamChunkSize * kStreamChunkCount];
+	struct iovec iov[kStreamChunkCount];
+	size_t index = 0;
+	Timer timer;
+	while (index < kStreamCount) {
+		timer.Start();
+		size_t n = 0, length = 0;
+		for (; n < kStreamChunkCount && index < kStreamCount; n++) {
+			iov[n].iov_base = buffer + n * kStreamChunkSize;
+			iov[n].iov_len = FormatStreamChunk(f, column, index, buffer + n * kStreamChunkSize, kStreamChunkSize);
+			length += iov[n].iov_len;
+		}
+		timer.Stop();
+		result.formatMs += timer.GetElapsedMilliseconds();
+
+		timer.Start();
+		if (writev(fd, iov, (int)n) != (ssize_t)length) {
+			perror("writev");
+			throw std::exception();
+		}
+		timer.Stop();
+		result.ioMs += timer.GetElapsedMilliseconds();
+		result.bytes += length;
+	}
+	delete[] buffer;
+}
+
+// Formats straight into a shared mapping of the file, sized for the longest
+// possible output and truncated afterwards. Page faults are part of the
+// formatting time; msync, munmap and the truncation are I/O.
+static void StreamMmap(void(*f)(double, char*), int fd, StreamResult& result) {
+	const double* column = StreamColumnData::GetData();
+	size_t capacity = kStreamCount * kStreamMaxLength;
+	if (ftruncate(fd, (off_t)capacity) != 0) {
+		perror("ftruncate");
+		throw std::exception();
+	}
+	char* map = (char*)mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED) {
+		perror("mmap");
+		throw std::exception();
+	}
+
+	Timer timer;
+	timer.Start();
+	size_t index = 0, length = 0;
+	while (index < kStreamCount)
+		length += FormatStreamChunk(f, column, index, map + length, kStreamChunkSize);
+	timer.Stop();
+	result.formatMs += timer.GetElapsedMilliseconds();
+
+	timer.Start();
+	msync(map, length, MS_SYNC);
+	munmap(map, capacity);
+	if (ftruncate(fd, (off_t)length) != 0) {
+		perror("ftruncate");
+		throw std::exception();
+	}
+	timer.Stop();
+	result.ioMs += timer.GetElapsedMilliseconds();
+	result.bytes += length;
+}
+
+static void BenchStreamMethod(void(*f)(double, char*), const char* fname, FILE* fp, const char* method, void(*stream)(void(*)(double, char*), int, StreamResult&)) {
+	printf("Benchmarking %13s %-20s ... ", method, fname);
+
+	StreamResult result;
+	int fd = OpenStreamFile();
+	MemoryProbe probe;
+	struct rusage before, after;
+	getrusage(RUSAGE_SELF, &before);
+
+	try {
+		stream(f, fd, result);
+
+		// Include flushing to the file system in the I/O time.
+		Timer timer;
+		timer.Start();
+		fsync(fd);
+		timer.Stop();
+		result.ioMs += timer.GetElapsedMilliseconds();
+	}
+	catch (...) {
+		close(fd);
+		printf("failed\n");
+		return;
+	}
+
+	getrusage(RUSAGE_SELF, &after);
+	close(fd);
+	result.userMs = CpuMilliseconds(after.ru_utime) - CpuMilliseconds(before.ru_utime);
+	result.systemMs = CpuMilliseconds(after.ru_stime) - CpuMilliseconds(before.ru_stime);
+
+	double totalMs = result.formatMs + result.ioMs;
+	double perValue = 1e6 / kStreamCount; // convert to nano second per value
+	fprintf(fp, "%s,%s,0,%f", method, fname, totalMs * perValue);
+	probe.WriteColumns(fp, kStreamCount);
+	fprintf(fp, "%s_format,%s,0,%f", method, fname, result.formatMs * perValue);
+	probe.WriteColumns(fp, kStreamCount);
+	fprintf(fp, "%s_io,%s,0,%f", method, fname, result.ioMs * perValue);
+	probe.WriteColumns(fp, kStreamCount);
+
+	printf("%6.3fGB/s format %8.1fms I/O %8.1fms (CPU user %8.1fms system %8.1fms)\n",
+		result.bytes / (totalMs * 1e6), result.formatMs, result.ioMs, result.userMs, result.systemMs);
+}
+
+void BenchStream(void(*f)(double, char*), const char* fname, FILE* fp) {
+	BenchStreamMethod(f, fname, fp, "stream_write", StreamWrite);
+	BenchStreamMethod(f, fname, fp, "stream_writev", StreamWritev);
+	BenchStreamMethod(f, fname, fp, "stream_mmap", StreamMmap);
+}
+
+#if __cplusplus >= 201103L
+
+// Formatting overlapped with I/O through Pipeline, for every combination of
+// buffer size and worker count. The results have the index of the buffer size
+// + 1 as Digit.
+const size_t kPipelineCount = 10000000;
+const size_t kPipelineBufferSizes[] = { 64 << 10, 256 << 10, 1 << 20, 4 << 20 };
+const unsigned kPipelineWorkerCounts[] = { 1, 2, 4 };
+
+struct PipelineContext {
+	void(*f)(double, char*);
+	void(*threadExit)();
+	const double* column;
+	size_t valuesPerChunk;
+	int fd;
+	bool failed;
+};
+
+static size_t PipelineFill(void* context, size_t chunk, char* buffer, size_t) {
+	const PipelineContext& c = *static_cast<PipelineContext*>(context);
+	size_t begin = chunk * c.valuesPerChunk;
+	size_t end = std::min(begin + c.valuesPerChunk, kPipelineCount);
+	char* p = buffer;
+	for (size_t i = begin; i < end; i++) {
+		*p = '\0';	// null writes nothing
+		c.f(c.column[i % StreamColumnData::kCount], p);
+		p += strlen(p);
+		*p++ = '\n';
+	}
+	return p - buffer;
+}
+
+static void PipelineWorkerExit(void* context) {
+	const PipelineContext& c = *static_cast<PipelineContext*>(context);
+	if (c.threadExit)
+		c.threadExit();
+}
+
+static void PipelineSink(void* context, const char* buffer, size_t length) {
+	PipelineContext& c = *static_cast<PipelineContext*>(context);
+	if (write(c.fd, buffer, length) != (ssize_t)length)
+		c.failed = true;
+}
+
+void BenchPipeline(void(*f)(double, char*), void(*threadExit)(), const char* fname, FILE* fp) {
+	const size_t sizeCount = sizeof(kPipelineBufferSizes) / sizeof(kPipelineBufferSizes[0]);
+	const size_t workerCount = sizeof(kPipelineWorkerCounts) / sizeof(kPipelineWorkerCounts[0]);
+
+	for (size_t w = 0; w < workerCount; w++) {
+		char type[32];
+		sprintf(type, "pipeline_%ut", kPipelineWorkerCounts[w]);
+		printf("Benchmarking %13s %-20s ... ", type, fname);
+
+		for (size_t b = 0; b < sizeCount; b++) {
+			PipelineConfig config;
+			config.bufferSize = kPipelineBufferSizes[b];
+			config.workerCount = kPipelineWorkerCounts[w];
+			config.bufferCount = 2 * config.workerCount + 2;
+
+			PipelineContext context;
+			context.f = f;
+			context.threadExit = threadExit;
+			context.column = StreamColumnData::GetData();
+			context.valuesPerChunk = config.bufferSize / kStreamMaxLength;
+			context.fd = OpenStreamFile();
+			context.failed = false;
+			size_t chunkCount = (kPipelineCount + context.valuesPerChunk - 1) / context.valuesPerChunk;
+
+			MemoryProbe probe;
+			Pipeline pipeline(config);
+			Timer timer;
+			timer.Start();
+			pipeline.Run(chunkCount, PipelineFill, PipelineSink, &context, PipelineWorkerExit);
+			fsync(context.fd);
+			timer.Stop();
+
+			off_t bytes = lseek(context.fd, 0, SEEK_END);
+			close(context.fd);
+			if (context.failed) {
+				printf("failed ");
+				continue;
+			}
+
+			double duration = timer.GetElapsedMilliseconds();
+			fprintf(fp, "%s,%s,%u,%f", type, fname, unsigned(b + 1), duration * 1e6 / kPipelineCount);
+			probe.WriteColumns(fp, kPipelineCount);
+			printf("%uKB %6.3fGB/s ", (unsigned)(config.bufferSize >> 10), bytes / (duration * 1e6));
+		}
+		printf("\n");
+	}
+}
+
+#endif // __cplusplus >= 201103L
+
+#endif // _WIN32
+
+// GeoJSON-style coordinates: rings of [longitude, latitude] pairs at full
+// double precision.
+class GeoJsonData {
+public:
+	static const double* GetData() {
+		static GeoJsonData singleton;
+		return singleton.mData;
+	}
+
+	static const size_t kRingCount = 100;
+	static const size_t kPointsPerRing = 100;
+	static const size_t kCount = kRingCount * kPointsPerRing * 2;
+
+private:
+	GeoJsonData() :
+		mData(new double[kCount])
+	{
+		Random r;
+		for (size_t i = 0; i < kCount; i += 2) {
+			mData[i] = r() / 4294967296.0 * 360.0 - 180.0;
+			mData[i + 1] = r() / 4294967296.0 * 180.0 - 90.0;
+		}
+	}
+
+	~GeoJsonData() {
+		delete[] mData;
+	}
+
+	double* mData;
+};
+
+// Telemetry records with the few significant digits sensors report.
+class TelemetryData {
+public:
+	static const double* GetData() {
+		static TelemetryData singleton;
+		return singleton.mData;
+	}
+
+	static const size_t kRecordCount = 2000;
+	static const size_t kFieldCount = 5;
+	static const size_t kCount = kRecordCount * kFieldCount;
+
+	static const char* GetKey(size_t field) {
+		static const char* keys[kFieldCount] = { "timestamp", "temperature", "pressure", "humidity", "voltage" };
+		return keys[field];
+	}
+
+private:
+	TelemetryData() :
+		mData(new double[kCount])
+	{
+		Random r;
+		double* p = mData;
+		for (size_t i = 0; i < kRecordCount; i++) {
+			*p++ = 1400000000.0 + i;
+			*p++ = Round(-20.0 + r() % 6000 / 100.0, 2);
+			*p++ = Round(950.0 + r() % 1000 / 10.0, 1);
+			*p++ = Round(r() % 1000 / 10.0, 1);
+			*p++ = Round(3.0 + r() % 1000 / 1000.0, 3);
+		}
+	}
+
+	~TelemetryData() {
+		delete[] mData;
+	}
+
+	// Nearest double of value printed with the given number of decimals.
+	static double Round(double value, int decimals) {
+		char buffer[256];
+		sprintf(buffer, "%.*f", decimals, value);
+		using namespace double_conversion;
+		StringToDoubleConverter converter(StringToDoubleConverter::NO_FLAGS, 0.0, 0.0, NULL, NULL);
+		int processed = 0;
+		return converter.StringToDouble(buffer, (int)strlen(buffer), &processed);
+	}
+
+	double* mData;
+};
+
+// {"coordinates":[[[lon,lat],...],...]}
+static size_t WriteGeoJson(void(*f)(double, char*)) {
+	const double* data = GeoJsonData::GetData();
+	JsonWriter writer(f);
+	writer.StartObject();
+	writer.Key("coordinates", 11);
+	writer.StartArray();
+	for (size_t ring = 0; ring < GeoJsonData::kRingCount; ring++) {
+		writer.StartArray();
+		for (size_t point = 0; point < GeoJsonData::kPointsPerRing; point++) {
+			writer.StartArray();
+			writer.Double(*data++);
+			writer.Double(*data++);
+			writer.EndArray();
+		}
+		writer.EndArray();
+	}
+	writer.EndArray();
+	writer.EndObject();
+	return writer.GetSize();
+}
+
+// [{"timestamp":t,"temperature":x,...},...]
+static size_t WriteTelemetry(void(*f)(double, char*)) {
+	const double* data = TelemetryData::GetData();
+	size_t keyLength[TelemetryData::kFieldCount];
+	for (size_t field = 0; field < TelemetryData::kFieldCount; field++)
+		keyLength[field] = strlen(TelemetryData::GetKey(field));
+
+	JsonWriter writer(f);
+	writer.StartArray();
+	for (size_t record = 0; record < TelemetryData::kRecordCount; record++) {
+		writer.StartObject();
+		for (size_t field = 0; field < TelemetryData::kFieldCount; field++) {
+			writer.Key(TelemetryData::GetKey(field), keyLength[field]);
+			writer.Double(*data++);
+		}
+		writer.EndObject();
+	}
+	writer.EndArray();
+	return writer.GetSize();
+}
+
+static void BenchJsonDocument(void(*f)(double, char*), const char* fname, FILE* fp, const char* type, size_t(*write)(void(*)(double, char*)), size_t numberCount) {
+	printf("Benchmarking %14s %-20s ... ", type, fname);
+
+	size_t size = 0;
+	MemoryProbe probe;
+	double duration = std::numeric_limits<double>::max();
+	for (unsigned trial = 0; trial < kTrial; trial++) {
+		Timer timer;
+		timer.Start();
+
+		for (unsigned iteration = 0; iteration < kIterationPerDigit; iteration++)
+			size = write(f);
+
+		timer.Stop();
+		duration = std::min(duration, timer.GetElapsedMilliseconds());
+	}
+
+	double megabytesPerSecond = size * kIterationPerDigit / (duration * 1e3);
+	duration *= 1e6 / (kIterationPerDigit * numberCount); // convert to nano second per number
+
+	fprintf(fp, "%s,%s,0,%f", type, fname, duration);
+	probe.WriteColumns(fp, double(kTrial) * kIterationPerDigit * numberCount);
+
+	printf("%8.3fns %8.1fMB/s\n", duration, megabytesPerSecond);
+}
+
+void BenchJson(void(*f)(double, char*), const char* fname, FILE* fp) {
+	BenchJsonDocument(f, fname, fp, "json_geo", WriteGeoJson, GeoJsonData::kCount);
+	BenchJsonDocument(f, fname, fp, "json_telemetry", WriteTelemetry, TelemetryData::kCount);
+}
+
+// Log lines: text with several doubles per line, as on a logging hot path.
+// One line per TelemetryData record:
+//   INFO telemetry t=1400000000 temperature=21.37 pressure=1012.5 humidity=47.1 voltage=3.305
+// Lines are appended to a large ring buffer, which wraps around when less
+// than kLogLineMaxLength bytes are left.
+const size_t kLogRingSize = 16 << 20;
+const size_t kLogLineMaxLength = STB_SPRINTF_MIN;	// stbsp_vsprintfcb writes up to STB_SPRINTF_MIN bytes per callback
+
+class LogRing {
+public:
+	LogRing() : mData(new char[kLogRingSize]), mHead(mData), mBytes(0) {}
+
+	~LogRing() {
+		delete[] mData;
+	}
+
+	// Space for at least kLogLineMaxLength bytes.
+	char* Reserve() {
+		if (size_t(mData + kLogRingSize - mHead) < kLogLineMaxLength)
+			mHead = mData;
+		return mHead;
+	}
+
+	void Commit(size_t length) {
+		mHead += length;
+		mBytes += length;
+	}
+
+	size_t GetBytes() const { return mBytes; }
+
+	// STBSP_SPRINTFCB: stb_sprintf formats in place, so a chunk only needs
+	// to be committed before handing out the space for the next one.
+	static char* StbCallback(char* buffer, void* user, int length) {
+		(void)buffer;
+		LogRing* ring = static_cast<LogRing*>(user);
+		ring->Commit(length);
+		return ring->Reserve();
+	}
+
+private:
+	LogRing(const LogRing&);
+	LogRing& operator=(const LogRing&);
+
+	char* mData;
+	char* mHead;
+	size_t mBytes;
+};
+
+typedef void (*LogLineFunc)(LogRing& ring, const double* record, void(*f)(double, char*));
+
+static void LogLineStb(LogRing& ring, const char* format, ...) {
+	va_list va;
+	va_start(va, format);
+	stbsp_vsprintfcb(LogRing::StbCallback, &ring, ring.Reserve(), format, va);
+	va_end(va);
+}
+
+static void LogLineStbG(LogRing& ring, const double* record, void(*)(double, char*)) {
+	LogLineStb(ring, "INFO telemetry t=%.17g temperature=%.17g pressure=%.17g humidity=%.17g voltage=%.17g\n",
+		record[0], record[1], record[2], record[3], record[4]);
+}
+
+static void LogLineStbShortest(LogRing& ring, const double* record, void(*)(double, char*)) {
+	LogLineStb(ring, "INFO telemetry t=%r temperature=%r pressure=%r humidity=%r voltage=%r\n",
+		record[0], record[1], record[2], record[3], record[4]);
+}
+
+static void LogLineSnprintf(LogRing& ring, const double* record, void(*)(double, char*)) {
+	int length = snprintf(ring.Reserve(), kLogLineMaxLength, "INFO telemetry t=%.17g temperature=%.17g pressure=%.17g humidity=%.17g voltage=%.17g\n",
+		record[0], record[1], record[2], record[3], record[4]);
+	ring.Commit(length);
+}
+
+// Hand-assembled: copies the text pieces and lets f write the numbers.
+static void LogLineConcat(LogRing& ring, const double* record, void(*f)(double, char*)) {
+	static const struct {
+		const char* text;
+		size_t length;
+	} kPieces[TelemetryData::kFieldCount] = {
+#define LOG_PIECE(s) { s, sizeof(s) - 1 }
+		LOG_PIECE("INFO telemetry t="),
+		LOG_PIECE(" temperature="),
+		LOG_PIECE(" pressure="),
+		LOG_PIECE(" humidity="),
+		LOG_PIECE(" voltage=")
+#undef LOG_PIECE
+	};
+
+	char* start = ring.Reserve();
+	char* p = start;
+	for (size_t field = 0; field < TelemetryData::kFieldCount; field++) {
+		memcpy(p, kPieces[field].text, kPieces[field].length);
+		p += kPieces[field].length;
+		*p = '\0';	// null writes nothing
+		f(record[field], p);
+		p += strlen(p);
+	}
+	*p++ = '\n';
+	ring.Commit(p - start);
+}
+
+static void BenchLogLineFormatter(LogLineFunc line, void(*f)(double, char*), const char* fname, FILE* fp) {
+	printf("Benchmarking     logline %-25s ... ", fname);
+
+	LogRing ring;
+	const double* data = TelemetryData::GetData();
+	size_t n = TelemetryData::kRecordCount;
+
+	MemoryProbe probe;
+	double duration = std::numeric_limits<double>::max();
+	for (unsigned trial = 0; trial < kTrial; trial++) {
+		Timer timer;
+		timer.Start();
+
+		for (unsigned iteration = 0; iteration < kIterationPerDigit; iteration++)
+			for (size_t i = 0; i < n; i++)
+				line(ring, data + i * TelemetryData::kFieldCount, f);
+
+		timer.Stop();
+		duration = std::min(duration, timer.GetElapsedMilliseconds());
+	}
+
+	double megabytesPerSecond = ring.GetBytes() / kTrial / (duration * 1e3);
+	duration *= 1e6 / (kIterationPerDigit * n); // convert to nano second per line
+
+	fprintf(fp, "logline,%s,0,%f", fname, duration);
+	probe.WriteColumns(fp, double(kTrial) * kIterationPerDigit * n);
+
+	printf("%8.3fns %8.1fMB/s\n", duration, megabytesPerSecond);
+}
+
+// The printf family formatting whole lines, then every registered
+// implementation in hand-assembled lines.
+void BenchLogLine(const TestList& tests, FILE* fp) {
+	BenchLogLineFormatter(LogLineStbG, 0, "stbsp_vsprintfcb", fp);
+	BenchLogLineFormatter(LogLineStbShortest, 0, "stbsp_vsprintfcb_shortest", fp);
+	BenchLogLineFormatter(LogLineSnprintf, 0, "snprintf", fp);
+
+	for (TestList::const_iterator itr = tests.begin(); itr != tests.end(); ++itr)
+		BenchLogLineFormatter(LogLineConcat, (*itr)->dtoa, (*itr)->fname, fp);
+}
+
+// Streaming output into a small buffer that is drained whenever it is full,
+// per value with fpconv_dtoa() and in batches with fpconv_dtoa_many().
+const size_t kBatchBufferSize = 4096;
+
+static size_t BatchPerValue(const double* data, size_t n, char* buffer, size_t capacity) {
+	size_t total = 0, length = 0;
+	for (size_t i = 0; i < n; i++) {
+		if (capacity - length < 24 + 1) {
+			total += length;	// drain
+			length = 0;
+		}
+		length += fpconv_dtoa(data[i], buffer + length);
+		buffer[length++] = '\n';
+	}
+	return total + length;
+}
+
+static size_t BatchMany(const double* data, size_t n, char* buffer, size_t capacity) {
+	size_t total = 0;
+	for (size_t i = 0; i < n; ) {
+		size_t length;
+		i += fpconv_dtoa_many(data + i, n - i, buffer, capacity, '\n', &length);
+		total += length;	// drain
+	}
+	return total;
+}
+
+// Checks that fpconv_dtoa_many() writes what fpconv_dtoa() does, whole
+// values only and nothing past the capacity, for capacities down to one
+// number.
+static bool VerifyBatch() {
+	const double* data = RandomDigitData::GetData(RandomDigitData::kMaxDigit);
+	size_t n = 100;
+	static const double kSpecials[] = { 0.0, -0.0, -1.5, 1e300, -5e-324 };
+
+	std::vector<char> expect;
+	for (size_t i = 0; i < n + 5; i++) {
+		char buffer[24];
+		int length = fpconv_dtoa(i < n ? data[i] : kSpecials[i - n], buffer);
+		expect.insert(expect.end(), buffer, buffer + length);
+		expect.push_back(',');
+	}
+	std::vector<double> values(data, data + n);
+	values.insert(values.end(), kSpecials, kSpecials + 5);
+
+	for (size_t capacity = 25; capacity <= 100; capacity++) {
+		std::vector<char> actual;
+		for (size_t i = 0; i < values.size(); ) {
+			char buffer[101 + 16];
+			memset(buffer, '#', sizeof(buffer));
+			size_t length;
+			size_t consumed = fpconv_dtoa_many(&values[i], values.size() - i, buffer, capacity, ',', &length);
+			if (consumed == 0 || length > capacity || buffer[capacity] != '#')
+				return false;
+			actual.insert(actual.end(), buffer, buffer + length);
+			i += consumed;
+		}
+		if (actual != expect)
+			return false;
+	}
+	return true;
+}
+
+// Writes type batch with the randomdigit digit count in the Digit column and
+// the time per value.
+void BenchBatch(FILE* fp) {
+	printf("Verifying fpconv_dtoa_many ... %s\n", VerifyBatch() ? "OK." : "failed.");
+
+	static const struct {
+		const char* fname;
+		size_t (*write)(const double*, size_t, char*, size_t);
+	} kMethods[] = {
+		{ "fpconv_dtoa", BatchPerValue },
+		{ "fpconv_dtoa_many", BatchMany }
+	};
+
+	char buffer[kBatchBufferSize];
+	for (size_t m = 0; m < sizeof(kMethods) / sizeof(kMethods[0]); m++) {
+		printf("Benchmarking batch %-20s ... ", kMethods[m].fname);
+
+		double minDuration = std::numeric_limits<double>::max();
+		double maxDuration = 0.0;
+		size_t bytes = 0;
+
+		for (int digit = 1; digit <= RandomDigitData::kMaxDigit; digit++) {
+			const double* data = RandomDigitData::GetData(digit);
+			size_t n = RandomDigitData::kCount;
+
+			MemoryProbe probe;
+			double duration = std::numeric_limits<double>::max();
+			for (unsigned trial = 0; trial < kTrial; trial++) {
+				Timer timer;
+				timer.Start();
+
+				for (unsigned iteration = 0; iteration < kIterationPerDigit; iteration++)
+					bytes += kMethods[m].write(data, n, buffer, sizeof(buffer));
+
+				timer.Stop();
+				duration = std::min(duration, timer.GetElapsedMilliseconds());
+			}
+
+			duration *= 1e6 / (kIterationPerDigit * n); // convert to nano second per operation
+			minDuration = std::min(minDuration, duration);
+			maxDuration = std::max(maxDuration, duration);
+			fprintf(fp, "batch,%s,%d,%f", kMethods[m].fname, digit, duration);
+			probe.WriteColumns(fp, double(kTrial) * kIterationPerDigit * n);
+		}
+		printf("[%8.3fns, %8.3fns]\n", minDuration, maxDuration);
+
+		// Keep the conversions from being optimized away.
+		if (bytes == 0)
+			printf("\n");
+	}
+}
+
+// Values for the fixed precision track: kCount values in each decade
+// [10^exponent, 10^(exponent + 1)) from kMinExponent to kMaxExponent, covering
+// sensor readings through prices to large counters, half of them negative.
+// The mixed set draws the decade of each value at random.
+class FixedData {
+public:
+	static const double* GetData(int exponent) {
+		assert(exponent >= kMinExponent && exponent <= kMaxExponent);
+		return Instance().mData + (exponent - kMinExponent) * kCount;
+	}
+
+	static const double* GetMixedData() {
+		return Instance().mData + kDecadeCount * kCount;
+	}
+
+	static const int kMinExponent = -8;
+	static const int kMaxExponent = 16;
+	static const int kDecadeCount = kMaxExponent - kMinExponent + 1;
+	static const int kMaxPrecision = 17;
+	static const size_t kCount = 1000;
+
+private:
+	static FixedData& Instance() {
+		static FixedData singleton;
+		return singleton;
+	}
+
+	FixedData() :
+		mData(new double[(kDecadeCount + 1) * kCount])
+	{
+		Random r;
+		double* p = mData;
+		for (int exponent = kMinExponent; exponent <= kMaxExponent; exponent++)
+			for (size_t i = 0; i < kCount; i++)
+				*p++ = Generate(r, exponent);
+
+		for (size_t i = 0; i < kCount; i++)
+			*p++ = Generate(r, kMinExponent + int(r() % kDecadeCount));
+	}
+
+	~FixedData() {
+		delete[] mData;
+	}
+
+	static double Generate(Random& r, int exponent) {
+		double mantissa = 1.0 + 9.0 * (r() / 4294967296.0);
+		double value = mantissa * pow(10.0, exponent);
+		return (r() & 1) ? -value : value;
+	}
+
+	double* mData;
+};
+
+// Writes the correctly rounded "%.*f" of value to expect, from
+// double-conversion's exact bignum path, which rounds halfway cases up. When
+// value lies exactly halfway between two outputs, writes the rounded down one
+// to tie and returns true, so either rounding of a tie is accepted.
+static bool FixedReference(double value, int precision, char* expect, char* tie) {
+	using namespace double_conversion;
+	if (value < 0 || (value == 0 && 1 / value < 0)) {
+		*expect++ = '-';
+		*tie++ = '-';
+		value = -value;
+	}
+
+	char digits[512];
+	int length = 0, point = 0;
+	if (value != 0)
+		BignumDtoa(value, BIGNUM_DTOA_FIXED, precision, Vector<char>(digits, sizeof(digits)), &length, &point);
+	FormatFixed(digits, length, point, precision, expect);
+
+	// value = m * 2^e times 10^precision ends in exactly .5 when
+	// m * 5^precision * 2^(e + precision + 1) is odd, i.e. when m has exactly
+	// -(e + precision + 1) trailing zero bits.
+	if (value == 0)
+		return false;
+	Double d(value);
+	uint64_t m = d.Significand();
+	int zeros = -(d.Exponent() + precision + 1);
+	if (zeros < 0 || zeros >= 64 || ((m >> zeros) & 1) == 0 || (m & ((uint64_t(1) << zeros) - 1)) != 0)
+		return false;
+
+	// The exact value then has precision + 1 fraction digits, the last one
+	// being 5; dropping it rounds down.
+	BignumDtoa(value, BIGNUM_DTOA_FIXED, precision + 1, Vector<char>(digits, sizeof(digits)), &length, &point);
+	FormatFixed(digits, length - 1, point, precision, tie);
+	return true;
+}
+
+static bool VerifyFixedValue(double value, int precision, void(*f)(double, int, char*), bool print) {
+	char expect[512], tie[512], actual[512];
+	bool tied = FixedReference(value, precision, expect, tie);
+	f(value, precision, actual);
+	if (strcmp(actual, expect) != 0 && !(tied && strcmp(actual, tie) == 0)) {
+		if (print)
+			printf("Error: %.17g with precision %d expect %s but actual %s\n", value, precision, expect, actual);
+		return false;
+	}
+	return true;
+}
+
+// Compares with the exact bignum path at every precision: boundary cases,
+// halfway cases, the first values of every FixedData decade and random bit
+// patterns below 1e21, the range of ECMAScript's toFixed. Only the first
+// errors are printed, since an implementation that limits the significant
+// digits (stb_sprintf keeps 17) fails on most large values.
+static void VerifyFixed(void(*f)(double, int, char*), const char* fname) {
+	printf("Verifying fixed %-20s ... ", fname);
+
+	static const double kCases[] = {
+		0.0, -0.0, 0.5, 1.5, 2.5, -2.5, 0.125, 0.375, 1.005, 9.995, 0.0049, 0.005, 0.05,
+		1.0 / 3.0, 2.0 / 3.0, 99.999999999999986, 999999.9999999, 123456789.125,
+		4503599627370495.5, 9007199254740993.0, 9223372036854775807.0, 1e20,
+		2.2250738585072014e-308, 4.9406564584124654e-324
+	};
+
+	const size_t kMaxPrintedErrors = 10;
+	size_t errors = 0;
+	for (int precision = 0; precision <= FixedData::kMaxPrecision; precision++) {
+		for (size_t i = 0; i < sizeof(kCases) / sizeof(kCases[0]); i++)
+			errors += !VerifyFixedValue(kCases[i], precision, f, errors < kMaxPrintedErrors);
+
+		for (int exponent = FixedData::kMinExponent; exponent <= FixedData::kMaxExponent; exponent++) {
+			const double* data = FixedData::GetData(exponent);
+			for (size_t i = 0; i < 100; i++)
+				errors += !VerifyFixedValue(data[i], precision, f, errors < kMaxPrintedErrors);
+		}
+	}
+
+	union {
+		double d;
+		uint64_t u;
+	}u;
+	Random r;
+
+	for (unsigned i = 0; i < kVerifyRandomCount / 10; i++) {
+		do {
+			// Need to call r() in two statements for cross-platform coherent sequence.
+			u.u = uint64_t(r()) << 32;
+			u.u |= uint64_t(r());
+		} while (isnan(u.d) || isinf(u.d) || fabs(u.d) >= 1e21);
+		errors += !VerifyFixedValue(u.d, int(r() % (FixedData::kMaxPrecision + 1)), f, errors < kMaxPrintedErrors);
+	}
+
+	if (errors == 0)
+		printf("OK.\n");
+	else
+		printf("%u errors.\n", (unsigned)errors);
+}
+
+void VerifyFixedAll() {
+	const FixedTestList& fixedTests = FixedTestManager::Instance().GetTests();
+
+	for (FixedTestList::const_iterator itr = fixedTests.begin(); itr != fixedTests.end(); ++itr)
+		VerifyFixed((*itr)->fixed, (*itr)->fname);
+}
+
+static double BenchFixedData(void(*f)(double, int, char*), int precision, const double* data, size_t n, const char* type, int digit, const char* fname, FILE* fp) {
+	char buffer[256];
+	MemoryProbe probe;
+	double duration = std::numeric_limits<double>::max();
+	for (unsigned trial = 0; trial < kTrial; trial++) {
+		Timer timer;
+		timer.Start();
+
+		for (unsigned iteration = 0; iteration < kIterationPerDigit; iteration++)
+			for (size_t i = 0; i < n; i++)
+				f(data[i], precision, buffer);
+
+		timer.Stop();
+		duration = std::min(duration, timer.GetElapsedMilliseconds());
+	}
+
+	duration *= 1e6 / (kIterationPerDigit * n); // convert to nano second per operation
+	fprintf(fp, "%s,%s,%d,%f", type, fname, digit, duration);
+	probe.WriteColumns(fp, double(kTrial) * kIterationPerDigit * n);
+	return duration;
+}
+
+// Precisions used by the magnitude sweep: prices and coordinates.
+const int kFixedMagnitudePrecisions[] = { 2, 6 };
+
+// Sweeps precision 0 to 17 over the mixed magnitudes (type fixed, Digit is
+// the precision + 1), then the decades at the precisions above (type
+// fixed_p<precision>, Digit is the decimal exponent - kMinExponent + 1).
+// Digit stays positive, as 0 means a type without a digit axis.
+void BenchFixed(void(*f)(double, int, char*), const char* fname, FILE* fp) {
+	printf("Benchmarking fixed %-20s ... ", fname);
+
+	double minDuration = std::numeric_limits<double>::max();
+	double maxDuration = 0.0;
+
+	for (int precision = 0; precision <= FixedData::kMaxPrecision; precision++) {
+		double duration = BenchFixedData(f, precision, FixedData::GetMixedData(), FixedData::kCount, "fixed", precision + 1, fname, fp);
+		minDuration = std::min(minDuration, duration);
+		maxDuration = std::max(maxDuration, duration);
+	}
+
+	for (size_t i = 0; i < sizeof(kFixedMagnitudePrecisions) / sizeof(kFixedMagnitudePrecisions[0]); i++) {
+		int precision = kFixedMagnitudePrecisions[i];
+		char type[32];
+		sprintf(type, "fixed_p%d", precision);
+		for (int exponent = FixedData::kMinExponent; exponent <= FixedData::kMaxExponent; exponent++) {
+			double duration = BenchFixedData(f, precision, FixedData::GetData(exponent), FixedData::kCount, type, exponent - FixedData::kMinExponent + 1, fname, fp);
+			minDuration = std::min(minDuration, duration);
+			maxDuration = std::max(maxDuration, duration);
+		}
+	}
+	printf("[%8.3fns, %8.3fns]\n", minDuration, maxDuration);
+}
+
+// Exact decimal expansion of a double: every finite double is a dyadic
+// rational with at most 767 significant decimal digits, so the bignum path
+// asked for more digits than that has nothing left to round.
+struct ExactDecimal {
+	explicit ExactDecimal(double value) : length(0), point(1) {
+		using namespace double_conversion;
+		if (value != 0) {
+			BignumDtoa(fabs(value), BIGNUM_DTOA_PRECISION, kMaxDigits, Vector<char>(digits, sizeof(digits)), &length, &point);
+			while (length > 0 && digits[length - 1] == '0')
+				length--;
+		}
+		digits[length] = '\0';
+	}
+
+	// Rounds to count significant digits, halfway cases down if tie is
+	// false and up if it is true, and returns whether value is such a case.
+	bool Round(int count, bool tie, char* result, int* resultPoint) const {
+		*resultPoint = point;
+		for (int i = 0; i < count; i++)
+			result[i] = i < length ? digits[i] : '0';
+		result[count] = '\0';
+		if (length <= count)
+			return false;
+
+		bool halfway = digits[count] == '5' && length == count + 1;
+		bool up = digits[count] > '5' || (digits[count] == '5' && (!halfway || tie));
+		if (up) {
+			int i = count - 1;
+			while (i >= 0 && result[i] == '9')
+				result[i--] = '0';
+			if (i >= 0)
+				result[i]++;
+			else {
+				result[0] = '1';
+				(*resultPoint)++;
+			}
+		}
+		return halfway;
+	}
+
+	static const int kMaxDigits = 800;
+	char digits[kMaxDigits + 1];
+	int length;
+	int point;
+};
+
+// Splits exponential output into its sign, the significant digits and the
+// decimal exponent, accepting any exponent style (e+05, e+5, e5, E-3). Returns
+// false if the layout is not one digit, an optional point and digits, then
+// the exponent.
+static bool ParseExponential(const char* s, bool* negative, char* digits, int* exponent) {
+	*negative = *s == '-';
+	if (*negative)
+		s++;
+	if (*s < '0' || *s > '9')
+		return false;
+	*digits++ = *s++;
+	if (*s == '.') {
+		s++;
+		while (*s >= '0' && *s <= '9')
+			*digits++ = *s++;
+	}
+	*digits = '\0';
+	if (*s != 'e' && *s != 'E')
+		return false;
+	s++;
+	char* end;
+	*exponent = static_cast<int>(strtol(s, &end, 10));
+	return end != s && *end == '\0';
+}
+
+static bool VerifyExponentialValue(double value, const ExactDecimal& exact, int digits, void(*f)(double, int, char*), bool print) {
+	char buffer[512];
+	f(value, digits, buffer);
+
+	bool negative;
+	char actual[512];
+	int exponent = 0;
+	bool valid = ParseExponential(buffer, &negative, actual, &exponent);
+
+	char expect[32], tie[32];
+	int point, tiePoint;
+	bool halfway = exact.Round(digits, true, expect, &point);
+	exact.Round(digits, false, tie, &tiePoint);
+	if (!valid || negative != (value < 0) ||
+		!((strcmp(actual, expect) == 0 && exponent == point - 1) ||
+		  (halfway && strcmp(actual, tie) == 0 && exponent == tiePoint - 1))) {
+		if (print)
+			printf("Error: %.17g with %d digits expect %s%c.%se%d but actual %s\n",
+				value, digits, value < 0 ? "-" : "", expect[0], expect + 1, point - 1, buffer);
+		return false;
+	}
+	return true;
+}
+
+// Compares the digits and exponent with the exact expansion of each value at
+// every digit count: boundary cases, halfway cases, the randomdigit values and
+// random bit patterns of the whole range. Exact halfway cases may round either
+// way. Only the first errors are printed.
+static void VerifyExponential(void(*f)(double, int, char*), const char* fname) {
+	printf("Verifying exponential %-20s ... ", fname);
+
+	static const double kCases[] = {
+		0.0, 1.0, 0.5, 1.5, 2.5, -2.5, 0.125, 1.005, 9.995, 99.5, 999.5, 0.1, 1.0 / 3.0,
+		2.0 / 3.0, 5e-324, 2.2250738585072014e-308, 1.7976931348623157e308, 9007199254740993.0,
+		1e21, 1e22, 1e23, 9.5e-5, 123456789012345678.0
+	};
+
+	const size_t kMaxPrintedErrors = 10;
+	size_t errors = 0;
+
+	for (size_t i = 0; i < sizeof(kCases) / sizeof(kCases[0]); i++) {
+		ExactDecimal exact(kCases[i]);
+		for (int digits = 1; digits <= RandomDigitData::kMaxDigit; digits++)
+			errors += !VerifyExponentialValue(kCases[i], exact, digits, f, errors < kMaxPrintedErrors);
+	}
+
+	for (int digit = 1; digit <= RandomDigitData::kMaxDigit; digit++) {
+		const double* data = RandomDigitData::GetData(digit);
+		for (size_t i = 0; i < 20; i++) {
+			ExactDecimal exact(data[i]);
+			for (int digits = 1; digits <= RandomDigitData::kMaxDigit; digits++)
+				errors += !VerifyExponentialValue(data[i], exact, digits, f, errors < kMaxPrintedErrors);
+		}
+	}
+
+	union {
+		double d;
+		uint64_t u;
+	}u;
+	Random r;
+
+	for (unsigned i = 0; i < kVerifyRandomCount / 10; i++) {
+		do {
+			// Need to call r() in two statements for cross-platform coherent sequence.
+			u.u = uint64_t(r()) << 32;
+			u.u |= uint64_t(r());
+		} while (isnan(u.d) || isinf(u.d));
+		ExactDecimal exact(u.d);
+		errors += !VerifyExponentialValue(u.d, exact, 1 + int(r() % RandomDigitData::kMaxDigit), f, errors < kMaxPrintedErrors);
+	}
+
+	if (errors == 0)
+		printf("OK.\n");
+	else
+		printf("%u errors.\n", (unsigned)errors);
+}
+
+void VerifyExponentialAll() {
+	const ExponentialTestList& exponentialTests = ExponentialTestManager::Instance().GetTests();
+
+	for (ExponentialTestList::const_iterator itr = exponentialTests.begin(); itr != exponentialTests.end(); ++itr)
+		VerifyExponential((*itr)->exponential, (*itr)->fname);
+}
+
+// Formats the 17 digit randomdigit values, i.e. random doubles of the whole
+// range, with 1 to 17 significant digits. Written with type exponential and
+// the requested digits in the Digit column.
+void BenchExponential(void(*f)(double, int, char*), const char* fname, FILE* fp) {
+	printf("Benchmarking exponential %-20s ... ", fname);
+
+	char buffer[256];
+	double minDuration = std::numeric_limits<double>::max();
+	double maxDuration = 0.0;
+
+	const double* data = RandomDigitData::GetData(RandomDigitData::kMaxDigit);
+	size_t n = RandomDigitData::kCount;
+
+	for (int digits = 1; digits <= RandomDigitData::kMaxDigit; digits++) {
+		MemoryProbe probe;
+		double duration = std::numeric_limits<double>::max();
+		for (unsigned trial = 0; trial < kTrial; trial++) {
+			Timer timer;
+			timer.Start();
+
+			for (unsigned iteration = 0; iteration < kIterationPerDigit; iteration++)
+				for (size_t i = 0; i < n; i++)
+					f(data[i], digits, buffer);
+
+			timer.Stop();
+			duration = std::min(duration, timer.GetElapsedMilliseconds());
+		}
+
+		duration *= 1e6 / (kIterationPerDigit * n); // convert to nano second per operation
+		minDuration = std::min(minDuration, duration);
+		maxDuration = std::max(maxDuration, duration);
+		fprintf(fp, "exponential,%s,%d,%f", fname, digits, duration);
+		probe.WriteColumns(fp, double(kTrial) * kIterationPerDigit * n);
+	}
+	printf("[%8.3fns, %8.3fns]\n", minDuration, maxDuration);
+}
+
+void BenchFloatSequential(void(*f)(float, char*), const char* fname, FILE* fp) {
+	printf("Benchmarking  float_sequential %-20s ... ", fname);
+
+	char buffer[256] = { '\0' };
+	double minDuration = std::numeric_limits<double>::max();
+	double maxDuration = 0.0;
+
+	int32_t start = 1;
+	for (int digit = 1; digit <= 9; digit++) {
+		int32_t end = start * 10;
+
+		MemoryProbe probe;
+		double duration = std::numeric_limits<double>::max();
+		for (unsigned trial = 0; trial < kTrial; trial++) {
+			int32_t v = start;
+			Random r;
+			v += int32_t(r() % unsigned(start));
+			float sign = 1;
+			Timer timer;
+			timer.Start();
+			for (unsigned iteration = 0; iteration < kIterationPerDigit; iteration++) {
+				float d = v * sign;
+				f(d, buffer);
+				sign = -sign;
+				v += 1;
+				if (v >= end)
+					v = start;
+			}
+			timer.Stop();
+			duration = std::min(duration, timer.GetElapsedMilliseconds());
+		}
+
+		duration *= 1e6 / kIterationPerDigit; // convert to nano second per operation
+		minDuration = std::min(minDuration, duration);
+		maxDuration = std::max(maxDuration, duration);
+		fprintf(fp, "float_sequential,%s,%d,%f", fname, digit, duration);
+		probe.WriteColumns(fp, kTrial * kIterationPerDigit);
+		start = end;
+	}
+
+	printf("[%8.3fns, %8.3fns]\n", minDuration, maxDuration);
+}
+
+class RandomFloatData {
+public:
+	static float* GetData() {
+		static RandomFloatData singleton;
+		return singleton.mData;
+	}
+
+	static const size_t kCount = 1000;
+
+private:
+	RandomFloatData() :
+		mData(new float[kCount])
+	{
+		Random r;
+		union {
+			float f;
+			uint32_t u;
+		}u;
+
+		for (size_t i = 0; i < kCount; i++) {
+			do {
+				u.u = r();
+			} while (isnan(u.f) || isinf(u.f));
+			mData[i] = u.f;
+		}
+	}
+
+	~RandomFloatData() {
+		delete[] mData;
+	}
+
+	float* mData;
+};
+
+void BenchFloatRandom(void(*f)(float, char*), const char* fname, FILE* fp) {
+	printf("Benchmarking      float_random %-20s ... ", fname);
+
+	char buffer[256];
+	float* data = RandomFloatData::GetData();
+	size_t n = RandomFloatData::kCount;
+
+	MemoryProbe probe;
+	double duration = std::numeric_limits<double>::max();
+	for (unsigned trial = 0; trial < kTrial; trial++) {
+		Timer timer;
+		timer.Start();
+
+		for (unsigned iteration = 0; iteration < kIterationForRandom; iteration++)
+			for (size_t i = 0; i < n; i++)
+				f(data[i], buffer);
+
+		timer.Stop();
+		duration = std::min(duration, timer.GetElapsedMilliseconds());
+	}
+
+	duration *= 1e6 / (kIterationForRandom * n); // convert to nano second per operation
+
+	fprintf(fp, "float_random,%s,0,%f", fname, duration);
+	probe.WriteColumns(fp, double(kTrial) * kIterationForRandom * n);
+
+	printf("%8.3fns\n", duration);
+}
+
+class RandomFloatDigitData {
+public:
+	static float* GetData(int digit) {
+		assert(digit >= 1 && digit <= 9);
+		static RandomFloatDigitData singleton;
+		return singleton.mData + (digit - 1) * kCount;
+	}
+
+	static const int kMaxDigit = 9;
+	static const size_t kCount = 1000;
+
+private:
+	RandomFloatDigitData() :
+		mData(new float[kMaxDigit * kCount])
+	{
+		Random r;
+		union {
+			float f;
+			uint32_t u;
+		}u;
+
+		float* p = mData;
+		for (int digit = 1; digit <= kMaxDigit; digit++) {
+			for (size_t i = 0; i < kCount; i++) {
+				do {
+					u.u = r();
+				} while (isnan(u.f) || isinf(u.f));
+
+				// Convert to string with limited digits, and convert it back.
+				char buffer[256];
+				sprintf(buffer, "%.*g", digit, u.f);
+				using namespace double_conversion;
+				StringToDoubleConverter converter(StringToDoubleConverter::ALLOW_TRAILING_JUNK, 0.0, 0.0, NULL, NULL);
+				int processed = 0;
+				float roundtrip = converter.StringToFloat(buffer, 256, &processed);
+
+				*p++ = roundtrip;
+			}
+		}
+	}
+
+	~RandomFloatDigitData() {
+		delete[] mData;
+	}
+
+	float* mData;
+};
+
+void BenchFloatRandomDigit(void(*f)(float, char*), const char* fname, FILE* fp) {
+	printf("Benchmarking float_randomdigit %-20s ... ", fname);
+
+	char buffer[256];
+	double minDuration = std::numeric_limits<double>::max();
+	double maxDuration = 0.0;
+
+	for (int digit = 1; digit <= RandomFloatDigitData::kMaxDigit; digit++) {
+		float* data = RandomFloatDigitData::GetData(digit);
+		size_t n = RandomFloatDigitData::kCount;
+
+		MemoryProbe probe;
+		double duration = std::numeric_limits<double>::max();
+		for (unsigned trial = 0; trial < kTrial; trial++) {
+			Timer timer;
+			timer.Start();
+
+			for (unsigned iteration = 0; iteration < kIterationPerDigit; iteration++)
+				for (size_t i = 0; i < n; i++)
+					f(data[i], buffer);
+
+			timer.Stop();
+			duration = std::min(duration, timer.GetElapsedMilliseconds());
+		}
+
+		duration *= 1e6 / (kIterationPerDigit * n); // convert to nano second per operation
+		minDuration = std::min(minDuration, duration);
+		maxDuration = std::max(maxDuration, duration);
+		fprintf(fp, "float_randomdigit,%s,%d,%f", fname, digit, duration);
+		probe.WriteColumns(fp, double(kTrial) * kIterationPerDigit * n);
+	}
+	printf("[%8.3fns, %8.3fns]\n", minDuration, maxDuration);
+}
+
+void BenchFloat(void(*f)(float, char*), const char* fname, FILE* fp) {
+	//BenchFloatSequential(f, fname, fp);
+	//BenchFloatRandom(f, fname, fp);
+	BenchFloatRandomDigit(f, fname, fp);
+}
+
+void Bench(const Test& test, FILE* fp) {
+	void(*f)(double, char*) = test.dtoa;
+	const char* fname = test.fname;
+	//BenchSequential(f, fname, fp);
+	//BenchRandom(f, fname, fp);
+	//BenchPath(f, fname, fp);
+	//BenchColdCache(f, fname, fp);
+	//BenchJson(f, fname, fp);
+#ifndef _WIN32
+	//BenchStream(f, fname, fp);
+#if __cplusplus >= 201103L
+	//BenchPipeline(f, test.threadExit, fname, fp);
+#endif
+#endif
+	BenchRandomDigit(f, fname, fp);
+}
+
+void BenchAll() {
+	// doublery to write to /result path, where template.php exists
+	FILE *fp;
+	if ((fp = fopen("../../result/template.php", "r")) != NULL) {
+		fclose(fp);
+		fp = fopen("../../result/" RESULT_FILENAME, "w");
+	}
+	else if ((fp = fopen("../result/template.php", "r")) != NULL) {
+		fclose(fp);
+		fp = fopen("../result/" RESULT_FILENAME, "w");
+	}
+	else
+		fp = fopen(RESULT_FILENAME, "w");
+
+	fprintf(fp, "Type,Function,Digit,Time(ns),Allocs/op,Bytes/op,PeakRSS(KB)\n");
+
+	const TestList& tests = TestManager::Instance().GetTests();
+
+	for (TestList::const_iterator itr = tests.begin(); itr != tests.end(); ++itr)
+		Bench(**itr, fp);
+
+	const FloatTestList& floatTests = FloatTestManager::Instance().GetTests();
+
+	for (FloatTestList::const_iterator itr = floatTests.begin(); itr != floatTests.end(); ++itr)
+		BenchFloat((*itr)->ftoa, (*itr)->fname, fp);
+
+	const AtodTestList& atodTests = AtodTestManager::Instance().GetTests();
+
+	for (AtodTestList::const_iterator itr = atodTests.begin(); itr != atodTests.end(); ++itr)
+		BenchAtod((*itr)->atod, (*itr)->fname, fp);
+
+	const FixedTestList& fixedTests = FixedTestManager::Instance().GetTests();
+
+	for (FixedTestList::const_iterator itr = fixedTests.begin(); itr != fixedTests.end(); ++itr)
+		BenchFixed((*itr)->fixed, (*itr)->fname, fp);
+
+	const ExponentialTestList& exponentialTests = ExponentialTestManager::Instance().GetTests();
+
+	for (ExponentialTestList::const_iterator itr = exponentialTests.begin(); itr != exponentialTests.end(); ++itr)
+		BenchExponential((*itr)->exponential, (*itr)->fname, fp);
+
+	//BenchLogLine(tests, fp);
+	//BenchBatch(fp);
+
+	fclose(fp);
+}
+
+int main() {
+	// sort tests
+	TestList& tests = TestManager::Instance().GetTests();
+	std::sort(tests.begin(), tests.end());
+	FloatTestList& floatTests = FloatTestManager::Instance().GetTests();
+	std::sort(floatTests.begin(), floatTests.end());
+	AtodTestList& atodTests = AtodTestManager::Instance().GetTests();
+	std::sort(atodTests.begin(), atodTests.end());
+	FixedTestList& fixedTests = FixedTestManager::Instance().GetTests();
+	std::sort(fixedTests.begin(), fixedTests.end());
+	ExponentialTestList& exponentialTests = ExponentialTestManager::Instance().GetTests();
+	std::sort(exponentialTests.begin(), exponentialTests.end());
+
+	if (!AllocationCounterEnabled())
+		printf("Note: Allocs/op and Bytes/op count operator new only (aligned forms included), not malloc\n");
+	printf("libdtoa dispatches to %s (set LIBDTOA_ISA to force scalar, sse42, avx2 or avx512)\n", libdtoa_isa_name(libdtoa_selected()));
 
 	VerifyAll();
+	//VerifyFloatExhaustive(ftoa_milo, "milo");
+	VerifyAtodAll();
+	VerifyFixedAll();
+	VerifyExponentialAll();
 	BenchAll();
 }
@@ -17,124 +17,190 @@ namespace gcc_ints
 
 #define UINT64_C2(h, l) ((static_cast<uint64_t>(h) << 32) | static_cast<uint64_t>(l))
 
-struct DiyFp {
-	DiyFp() {}
-
-	DiyFp(uint64_t f, int e) : f(f), e(e) {}
+// IEEE-754 layout and DiyFp arithmetic of each supported floating point type.
+// double uses 64-bit DiyFp significands, float uses 32-bit ones.
+template <typename T>
+struct FloatTraits;
 
-	DiyFp(double d) {
-		union {
-			double d;
-			uint64_t u64;
-		} u = { d };
+template <>
+struct FloatTraits<double> {
+	typedef uint64_t Significand;
 
-		int biased_e = (u.u64 & kDpExponentMask) >> kDpSignificandSize;
-		uint64_t significand = (u.u64 & kDpSignificandMask);
-		if (biased_e != 0) {
-			f = significand + kDpHiddenBit;
-			e = biased_e - kDpExponentBias;
-		} 
-		else {
-			f = significand;
-			e = kDpMinExponent + 1;
-		}
-	}
-
-	DiyFp operator-(const DiyFp& rhs) const {
-		assert(e == rhs.e);
-		assert(f >= rhs.f);
-		return DiyFp(f - rhs.f, e);
-	}
+	static const int kDiySignificandSize = 64;
+	static const int kDpSignificandSize = 52;
+	static const int kDpExponentBias = 0x3FF + kDpSignificandSize;
+	static const int kDpMinExponent = -kDpExponentBias;
+	static const uint64_t kDpExponentMask = UINT64_C2(0x7FF00000, 0x00000000);
+	static const uint64_t kDpSignificandMask = UINT64_C2(0x000FFFFF, 0xFFFFFFFF);
+	static const uint64_t kDpHiddenBit = UINT64_C2(0x00100000, 0x00000000);
 
-	DiyFp operator*(const DiyFp& rhs) const {
+	// Upper 64 bits of the 128-bit product, rounded.
+	static uint64_t MultiplyHigh(uint64_t x, uint64_t y) {
 #if defined(_MSC_VER) && defined(_M_AMD64)
 		uint64_t h;
-		uint64_t l = _umul128(f, rhs.f, &h);
+		uint64_t l = _umul128(x, y, &h);
 		if (l & (uint64_t(1) << 63)) // rounding
 			h++;
-		return DiyFp(h, e + rhs.e + 64);
+		return h;
 #elif (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6)) && defined(__x86_64__)
-        gcc_ints::uint128 p = static_cast<gcc_ints::uint128>(f) * static_cast<gcc_ints::uint128>(rhs.f);
+        gcc_ints::uint128 p = static_cast<gcc_ints::uint128>(x) * static_cast<gcc_ints::uint128>(y);
 		uint64_t h = p >> 64;
 		uint64_t l = static_cast<uint64_t>(p);
 		if (l & (uint64_t(1) << 63)) // rounding
 			h++;
-		return DiyFp(h, e + rhs.e + 64);
+		return h;
 #else
 		const uint64_t M32 = 0xFFFFFFFF;
-		const uint64_t a = f >> 32;
-		const uint64_t b = f & M32;
-		const uint64_t c = rhs.f >> 32;
-		const uint64_t d = rhs.f & M32;
+		const uint64_t a = x >> 32;
+		const uint64_t b = x & M32;
+		const uint64_t c = y >> 32;
+		const uint64_t d = y & M32;
 		const uint64_t ac = a * c;
 		const uint64_t bc = b * c;
 		const uint64_t ad = a * d;
 		const uint64_t bd = b * d;
 		uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32);
 		tmp += 1U << 31;  /// mult_round
-		return DiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), e + rhs.e + 64);
+		return ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
 #endif
 	}
 
-	DiyFp Normalize() const {
+	// Number of leading zeros, f != 0.
+	static int CountLeadingZeros(uint64_t f) {
 #if defined(_MSC_VER) && defined(_M_AMD64)
 		unsigned long index;
 		_BitScanReverse64(&index, f);
-		return DiyFp(f << (63 - index), e - (63 - index));
+		return 63 - static_cast<int>(index);
 #elif defined(__GNUC__)
-		int s = __builtin_clzll(f);
-		return DiyFp(f << s, e - s);
+		return __builtin_clzll(f);
 #else
-		DiyFp res = *this;
-		while (!(res.f & kDpHiddenBit)) {
-			res.f <<= 1;
-			res.e--;
+		int s = 0;
+		while (!(f & (uint64_t(1) << 63))) {
+			f <<= 1;
+			s++;
 		}
-		res.f <<= (kDiySignificandSize - kDpSignificandSize - 1);
-		res.e = res.e - (kDiySignificandSize - kDpSignificandSize - 1);
-		return res;
+		return s;
+#endif
+	}
+};
+
+template <>
+struct FloatTraits<float> {
+	typedef uint32_t Significand;
+
+	static const int kDiySignificandSize = 32;
+	static const int kDpSignificandSize = 23;
+	static const int kDpExponentBias = 0x7F + kDpSignificandSize;
+	static const int kDpMinExponent = -kDpExponentBias;
+	static const uint32_t kDpExponentMask = 0x7F800000;
+	static const uint32_t kDpSignificandMask = 0x007FFFFF;
+	static const uint32_t kDpHiddenBit = 0x00800000;
+
+	// Upper 32 bits of the 64-bit product, rounded.
+	static uint32_t MultiplyHigh(uint32_t x, uint32_t y) {
+		uint64_t p = static_cast<uint64_t>(x) * y;
+		uint32_t h = static_cast<uint32_t>(p >> 32);
+		if (p & (uint64_t(1) << 31)) // rounding
+			h++;
+		return h;
+	}
+
+	// Number of leading zeros, f != 0.
+	static int CountLeadingZeros(uint32_t f) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse(&index, f);
+		return 31 - static_cast<int>(index);
+#elif defined(__GNUC__)
+		return __builtin_clz(f);
+#else
+		int s = 0;
+		while (!(f & (uint32_t(1) << 31))) {
+			f <<= 1;
+			s++;
+		}
+		return s;
 #endif
 	}
+};
+
+template <typename T>
+struct DiyFp {
+	typedef FloatTraits<T> Traits;
+	typedef typename Traits::Significand Significand;
+
+	DiyFp() {}
+
+	DiyFp(Significand f, int e) : f(f), e(e) {}
+
+	DiyFp(T d) {
+		union {
+			T d;
+			Significand u;
+		} u = { d };
+
+		int biased_e = static_cast<int>((u.u & Traits::kDpExponentMask) >> Traits::kDpSignificandSize);
+		Significand significand = (u.u & Traits::kDpSignificandMask);
+		if (biased_e != 0) {
+			f = significand + Traits::kDpHiddenBit;
+			e = biased_e - Traits::kDpExponentBias;
+		} 
+		else {
+			f = significand;
+			e = Traits::kDpMinExponent + 1;
+		}
+	}
+
+	DiyFp operator-(const DiyFp& rhs) const {
+		assert(e == rhs.e);
+		assert(f >= rhs.f);
+		return DiyFp(f - rhs.f, e);
+	}
+
+	DiyFp operator*(const DiyFp& rhs) const {
+		return DiyFp(Traits::MultiplyHigh(f, rhs.f), e + rhs.e + Traits::kDiySignificandSize);
+	}
+
+	DiyFp Normalize() const {
+		int s = Traits::CountLeadingZeros(f);
+		return DiyFp(f << s, e - s);
+	}
 
 	DiyFp NormalizeBoundary() const {
 #if defined(_MSC_VER) && defined(_M_AMD64)
-		unsigned long index;
-		_BitScanReverse64(&index, f);
-		return DiyFp (f << (63 - index), e - (63 - index));
+		int s = Traits::CountLeadingZeros(f);
+		return DiyFp(f << s, e - s);
 #else
 		DiyFp res = *this;
-		while (!(res.f & (kDpHiddenBit << 1))) {
+		while (!(res.f & (Traits::kDpHiddenBit << 1))) {
 			res.f <<= 1;
 			res.e--;
 		}
-		res.f <<= (kDiySignificandSize - kDpSignificandSize - 2);
-		res.e = res.e - (kDiySignificandSize - kDpSignificandSize - 2);
+		res.f <<= (Traits::kDiySignificandSize - Traits::kDpSignificandSize - 2);
+		res.e = res.e - (Traits::kDiySignificandSize - Traits::kDpSignificandSize - 2);
 		return res;
 #endif
 	}
 
 	void NormalizedBoundaries(DiyFp* minus, DiyFp* plus) const {
 		DiyFp pl = DiyFp((f << 1) + 1, e - 1).NormalizeBoundary();
-		DiyFp mi = (f == kDpHiddenBit) ? DiyFp((f << 2) - 1, e - 2) : DiyFp((f << 1) - 1, e - 1);
+		DiyFp mi = (f == Traits::kDpHiddenBit) ? DiyFp((f << 2) - 1, e - 2) : DiyFp((f << 1) - 1, e - 1);
 		mi.f <<= mi.e - pl.e;
 		mi.e = pl.e;
 		*plus = pl;
 		*minus = mi;
 	}
 
-	static const int kDiySignificandSize = 64;
-	static const int kDpSignificandSize = 52;
-	static const int kDpExponentBias = 0x3FF + kDpSignificandSize;
-	static const int kDpMinExponent = -kDpExponentBias;
-	static const uint64_t kDpExponentMask = UINT64_C2(0x7FF00000, 0x00000000);
-	static const uint64_t kDpSignificandMask = UINT64_C2(0x000FFFFF, 0xFFFFFFFF);
-	static const uint64_t kDpHiddenBit = UINT64_C2(0x00100000, 0x00000000);
-
-	uint64_t f;
+	Significand f;
 	int e;
 };
 
-inline DiyFp GetCachedPower(int e, int* K) {
+// Returns c = 10^-K with e + c.e + kDiySignificandSize in the range DigitGen() expects.
+template <typename T>
+DiyFp<T> GetCachedPower(int e, int* K);
+
+template <>
+inline DiyFp<double> GetCachedPower<double>(int e, int* K) {
 	// 10^-348, 10^-340, ..., 10^340
 	static const uint64_t kCachedPowers_F[] = {
 		UINT64_C2(0xfa8fd5a0, 0x081c0288), UINT64_C2(0xbaaee17f, 0xa23ebf76),
@@ -204,10 +270,36 @@ inline DiyFp GetCachedPower(int e, int* K) {
 	*K = -(-348 + static_cast<int>(index << 3));	// decimal exponent no need lookup table
 
 	assert(index < sizeof(kCachedPowers_F) / sizeof(kCachedPowers_F[0]));
-	return DiyFp(kCachedPowers_F[index], kCachedPowers_E[index]);
+	return DiyFp<double>(kCachedPowers_F[index], kCachedPowers_E[index]);
+}
+
+template <>
+inline DiyFp<float> GetCachedPower<float>(int e, int* K) {
+	// 10^-40, 10^-32, ..., 10^48
+	static const uint32_t kCachedPowers_F[] = {
+		0x8b61313c, 0xcfb11ead, 0x9abe14cd, 0xe69594bf, 0xabcc7712, 0x80000000,
+		0xbebc2000, 0x8e1bc9bf, 0xd3c21bcf, 0x9dc5ada8, 0xeb194f8e, 0xaf298d05
+	};
+	static const int16_t kCachedPowers_E[] = {
+		-164, -138, -111, -85, -58, -31, -5, 22, 48, 75, 101, 128
+	};
+
+	// Smallest cached power with W.e >= -28, so W.e lies in [-28, -1]: the integral
+	// part fits in 32 bits and fractional digits can be multiplied by 10 without overflow.
+	double dk = (-29 - e) * 0.30102999566398114 + 40;	// dk must be positive, so can do ceiling in positive
+	int k = static_cast<int>(dk);
+	if (dk - k > 0.0)
+		k++;
+
+	unsigned index = static_cast<unsigned>((k + 7) >> 3);
+	*K = -(-40 + static_cast<int>(index << 3));	// decimal exponent no need lookup table
+
+	assert(index < sizeof(kCachedPowers_F) / sizeof(kCachedPowers_F[0]));
+	return DiyFp<float>(kCachedPowers_F[index], kCachedPowers_E[index]);
 }
 
-inline void GrisuRound(char* buffer, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w) {
+template <typename Significand>
+inline void GrisuRound(char* buffer, int len, Significand delta, Significand rest, Significand ten_kappa, Significand wp_w) {
 	while (rest < wp_w && delta - rest >= ten_kappa &&
 		   (rest + ten_kappa < wp_w ||  /// closer
 			wp_w - rest > rest + ten_kappa - wp_w)) {
@@ -230,12 +322,14 @@ inline unsigned CountDecimalDigit32(uint32_t n) {
 	return 10;
 }
 
-inline void DigitGen(const DiyFp& W, const DiyFp& Mp, uint64_t delta, char* buffer, int* len, int* K) {
+template <typename T>
+inline void DigitGen(const DiyFp<T>& W, const DiyFp<T>& Mp, typename DiyFp<T>::Significand delta, char* buffer, int* len, int* K) {
+	typedef typename DiyFp<T>::Significand Significand;
 	static const uint32_t kPow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
-	const DiyFp one(uint64_t(1) << -Mp.e, Mp.e);
-	const DiyFp wp_w = Mp - W;
+	const DiyFp<T> one(Significand(1) << -Mp.e, Mp.e);
+	const DiyFp<T> wp_w = Mp - W;
 	uint32_t p1 = static_cast<uint32_t>(Mp.f >> -one.e);
-	uint64_t p2 = Mp.f & (one.f - 1);
+	Significand p2 = Mp.f & (one.f - 1);
 	int kappa = static_cast<int>(CountDecimalDigit32(p1));
 	*len = 0;
 
@@ -264,10 +358,10 @@ inline void DigitGen(const DiyFp& W, const DiyFp& Mp, uint64_t delta, char* buff
 		if (d || *len)
 			buffer[(*len)++] = '0' + static_cast<char>(d);
 		kappa--;
-		uint64_t tmp = (static_cast<uint64_t>(p1) << -one.e) + p2;
+		Significand tmp = (static_cast<Significand>(p1) << -one.e) + p2;
 		if (tmp <= delta) {
 			*K += kappa;
-			GrisuRound(buffer, *len, delta, tmp, static_cast<uint64_t>(kPow10[kappa]) << -one.e, wp_w.f);
+			GrisuRound(buffer, *len, delta, tmp, static_cast<Significand>(kPow10[kappa]) << -one.e, wp_w.f);
 			return;
 		}
 	}
@@ -283,26 +377,105 @@ inline void DigitGen(const DiyFp& W, const DiyFp& Mp, uint64_t delta, char* buff
 		kappa--;
 		if (p2 < delta) {
 			*K += kappa;
-			GrisuRound(buffer, *len, delta, p2, one.f, wp_w.f * kPow10[-kappa]);
+			GrisuRound(buffer, *len, delta, p2, one.f, static_cast<Significand>(wp_w.f * kPow10[-kappa]));
 			return;
 		}
 	}
 }
 
-inline void Grisu2(double value, char* buffer, int* length, int* K) {
-	const DiyFp v(value);
-	DiyFp w_m, w_p;
+template <typename T>
+inline void Grisu2(T value, char* buffer, int* length, int* K) {
+	const DiyFp<T> v(value);
+	DiyFp<T> w_m, w_p;
 	v.NormalizedBoundaries(&w_m, &w_p);
 
-	const DiyFp c_mk = GetCachedPower(w_p.e, K);
-	const DiyFp W = v.Normalize() * c_mk;
-	DiyFp Wp = w_p * c_mk;
-	DiyFp Wm = w_m * c_mk;
+	const DiyFp<T> c_mk = GetCachedPower<T>(w_p.e, K);
+	const DiyFp<T> W = v.Normalize() * c_mk;
+	DiyFp<T> Wp = w_p * c_mk;
+	DiyFp<T> Wm = w_m * c_mk;
 	Wm.f++;
 	Wp.f--;
 	DigitGen(W, Wp, Wp.f - Wm.f, buffer, length, K);
 }
 
+// Rounds the requested digits of a counted DigitGenCounted(): rest is what is
+// left of W below the last digit, ten_kappa the value of one unit of the last
+// digit, and unit the error of W on the same scale. Returns false if the error
+// could flip the rounding. Rounding up carries through nines: 999 -> 100, K + 1.
+template <typename Significand>
+inline bool GrisuRoundCounted(char* buffer, int len, Significand rest, Significand ten_kappa, Significand unit, int* K) {
+	if (unit >= ten_kappa || ten_kappa - unit <= unit)
+		return false;
+
+	// 2 * (rest + unit) <= ten_kappa: round down
+	if (ten_kappa - rest > rest && ten_kappa - 2 * rest >= 2 * unit)
+		return true;
+
+	// 2 * (rest - unit) >= ten_kappa: round up
+	if (rest > unit && ten_kappa - (rest - unit) <= rest - unit) {
+		int i = len - 1;
+		while (i >= 0 && buffer[i] == '9')
+			buffer[i--] = '0';
+		if (i >= 0)
+			buffer[i]++;
+		else {
+			buffer[0] = '1';
+			(*K)++;
+		}
+		return true;
+	}
+	return false;
+}
+
+// Generates exactly requested digits of W, the counted mode of Grisu3
+// (double-conversion's DigitGenCounted). W is off by less than one unit, which
+// is scaled along with the fractional digits, so generation stops with false
+// once the error reaches the digits being generated.
+template <typename T>
+inline bool DigitGenCounted(const DiyFp<T>& W, int requested, char* buffer, int* len, int* K) {
+	typedef typename DiyFp<T>::Significand Significand;
+	static const uint32_t kPow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+	const DiyFp<T> one(Significand(1) << -W.e, W.e);
+	uint32_t p1 = static_cast<uint32_t>(W.f >> -one.e);
+	Significand p2 = W.f & (one.f - 1);
+	Significand unit = 1;
+	int kappa = static_cast<int>(CountDecimalDigit32(p1));
+	*len = 0;
+
+	while (kappa > 0) {
+		const uint32_t d = p1 / kPow10[kappa - 1];
+		p1 %= kPow10[kappa - 1];
+		buffer[(*len)++] = '0' + static_cast<char>(d);
+		kappa--;
+		if (*len == requested) {
+			*K += kappa;
+			const Significand rest = (static_cast<Significand>(p1) << -one.e) + p2;
+			return GrisuRoundCounted(buffer, *len, rest, static_cast<Significand>(kPow10[kappa]) << -one.e, unit, K);
+		}
+	}
+
+	while (*len < requested && p2 > unit) {
+		p2 *= 10;
+		unit *= 10;
+		buffer[(*len)++] = '0' + static_cast<char>(p2 >> -one.e);
+		p2 &= one.f - 1;
+		kappa--;
+	}
+	if (*len < requested)
+		return false;
+	*K += kappa;
+	return GrisuRoundCounted(buffer, *len, p2, one.f, unit, K);
+}
+
+// requested (1 to 17) correctly rounded significant digits of value, such that
+// value ~= buffer * 10^K. Returns false when the result cannot be guaranteed.
+template <typename T>
+inline bool GrisuCounted(T value, int requested, char* buffer, int* length, int* K) {
+	const DiyFp<T> w = DiyFp<T>(value).Normalize();
+	const DiyFp<T> c_mk = GetCachedPower<T>(w.e, K);
+	return DigitGenCounted(w * c_mk, requested, buffer, length, K);
+}
+
 inline const char* GetDigitsLut() {
 	static const char cDigitsLut[200] = {
 		'0', '0', '0', '1', '0', '2', '0', '3', '0', '4', '0', '5', '0', '6', '0', '7', '0', '8', '0', '9',
@@ -319,11 +492,65 @@ inline const char* GetDigitsLut() {
 	return cDigitsLut;
 }
 
+// Output format policies for dtoa_milo<Format>().
+// All members are compile-time constants, so each instantiation of Prettify() folds
+// its format decisions away instead of testing them per call.
+// Decimal notation is used when kMinDecimalExponent < kk <= kMaxDecimalExponent,
+// where 10^(kk-1) <= v < 10^kk; otherwise exponential notation is used.
+
+// JavaScript Number.prototype.toString(): 1.0, 0.001234, 1.234e33
+struct JavaScriptFormat {
+	static const bool kIntegerPoint = true;		// 1 -> 1.0
+	static const int kMinDecimalExponent = -6;
+	static const int kMaxDecimalExponent = 21;
+	static const bool kExponentPlus = false;	// 1e30 instead of 1e+30
+	static const int kExponentMinDigits = 1;
+};
+
+// Minimal JSON number: 1, 0.001234, 1.234e33
+struct JsonFormat {
+	static const bool kIntegerPoint = false;
+	static const int kMinDecimalExponent = -6;
+	static const int kMaxDecimalExponent = 21;
+	static const bool kExponentPlus = false;
+	static const int kExponentMinDigits = 1;
+};
+
+// Always exponential: 1e0, 1.234e-3, 1.234e33
+struct ScientificFormat {
+	static const bool kIntegerPoint = false;
+	static const int kMinDecimalExponent = 0;
+	static const int kMaxDecimalExponent = 0;
+	static const bool kExponentPlus = false;
+	static const int kExponentMinDigits = 1;
+};
+
+// printf("%.17g") layout with shortest digits: 1, 0.0001234, 1.234e-05, 1.234e+33
+struct PrintfGFormat {
+	static const bool kIntegerPoint = false;
+	static const int kMinDecimalExponent = -4;
+	static const int kMaxDecimalExponent = 17;
+	static const bool kExponentPlus = true;
+	static const int kExponentMinDigits = 2;
+};
+
+// printf("%e") layout: always exponential, 1e+00, 1.234e-03, 1.234e+33
+struct PrintfEFormat {
+	static const bool kIntegerPoint = false;
+	static const int kMinDecimalExponent = 0;
+	static const int kMaxDecimalExponent = 0;
+	static const bool kExponentPlus = true;
+	static const int kExponentMinDigits = 2;
+};
+
+template <typename Format>
 inline void WriteExponent(int K, char* buffer) {
 	if (K < 0) {
 		*buffer++ = '-';
 		K = -K;
 	}
+	else if (Format::kExponentPlus)
+		*buffer++ = '+';
 
 	if (K >= 100) {
 		*buffer++ = '0' + static_cast<char>(K / 100);
@@ -332,7 +559,7 @@ inline void WriteExponent(int K, char* buffer) {
 		*buffer++ = d[0];
 		*buffer++ = d[1];
 	}
-	else if (K >= 10) {
+	else if (K >= 10 || Format::kExponentMinDigits >= 2) {
 		const char* d = GetDigitsLut() + K * 2;
 		*buffer++ = d[0];
 		*buffer++ = d[1];
@@ -343,24 +570,29 @@ inline void WriteExponent(int K, char* buffer) {
 	*buffer = '\0';
 }
 
+template <typename Format>
 inline void Prettify(char* buffer, int length, int k) {
 	const int kk = length + k;	// 10^(kk-1) <= v < 10^kk
 
-	if (length <= kk && kk <= 21) {
+	if (length <= kk && kk <= Format::kMaxDecimalExponent) {
 		// 1234e7 -> 12340000000
 		for (int i = length; i < kk; i++)
 			buffer[i] = '0';
-		buffer[kk] = '.';
-		buffer[kk + 1] = '0';
-		buffer[kk + 2] = '\0';
+		if (Format::kIntegerPoint) {
+			buffer[kk] = '.';
+			buffer[kk + 1] = '0';
+			buffer[kk + 2] = '\0';
+		}
+		else
+			buffer[kk] = '\0';
 	}
-	else if (0 < kk && kk <= 21) {
+	else if (0 < kk && kk <= Format::kMaxDecimalExponent) {
 		// 1234e-2 -> 12.34
 		memmove(&buffer[kk + 1], &buffer[kk], length - kk);
 		buffer[kk] = '.';
 		buffer[length + 1] = '\0';
 	}
-	else if (-6 < kk && kk <= 0) {
+	else if (Format::kMinDecimalExponent < kk && kk <= 0) {
 		// 1234e-6 -> 0.001234
 		const int offset = 2 - kk;
 		memmove(&buffer[offset], &buffer[0], length);
@@ -373,27 +605,26 @@ inline void Prettify(char* buffer, int length, int k) {
 	else if (length == 1) {
 		// 1e30
 		buffer[1] = 'e';
-		WriteExponent(kk - 1, &buffer[2]);
+		WriteExponent<Format>(kk - 1, &buffer[2]);
 	}
 	else {
 		// 1234e30 -> 1.234e33
 		memmove(&buffer[2], &buffer[1], length - 1);
 		buffer[1] = '.';
 		buffer[length + 1] = 'e';
-		WriteExponent(kk - 1, &buffer[0 + length + 2]);
+		WriteExponent<Format>(kk - 1, &buffer[0 + length + 2]);
 	}
 }
 
-inline void dtoa_milo(double value, char* buffer) {
+template <typename Format, typename T>
+inline void dtoa_milo(T value, char* buffer) {
 	// Not handling NaN and inf
 	assert(!isnan(value));
 	assert(!isinf(value));
 
 	if (value == 0) {
 		buffer[0] = '0';
-		buffer[1] = '.';
-		buffer[2] = '0';
-		buffer[3] = '\0';
+		Prettify<Format>(buffer, 1, 0);
 	}
 	else {
 		if (value < 0) {
@@ -402,6 +633,42 @@ inline void dtoa_milo(double value, char* buffer) {
 		}
 		int length, K;
 		Grisu2(value, buffer, &length, &K);
-		Prettify(buffer, length, K);
+		Prettify<Format>(buffer, length, K);
+	}
+}
+
+// requested significant digits in exponential notation, like
+// printf("%.*e", requested - 1) with the exponent written per Format, which
+// must always be exponential (ScientificFormat or PrintfEFormat). Returns
+// false, writing nothing useful, when GrisuCounted() gives up; the caller then
+// needs an exact (bignum) method.
+template <typename Format, typename T>
+inline bool dtoa_milo_exponential(T value, int requested, char* buffer) {
+	// Not handling NaN and inf
+	assert(!isnan(value));
+	assert(!isinf(value));
+
+	if (value < 0 || (value == 0 && 1 / value < 0)) {
+		*buffer++ = '-';
+		value = -value;
 	}
+
+	int length, K;
+	if (value == 0) {
+		for (length = 0; length < requested; length++)
+			buffer[length] = '0';
+		K = 1 - requested;
+	}
+	else if (!GrisuCounted(value, requested, buffer, &length, &K))
+		return false;
+	Prettify<Format>(buffer, length, K);
+	return true;
+}
+
+inline void dtoa_milo(double value, char* buffer) {
+	dtoa_milo<JavaScriptFormat>(value, buffer);
+}
+
+inline void dtoa_milo(float value, char* buffer) {
+	dtoa_milo<JavaScriptFormat>(value, buffer);
 }
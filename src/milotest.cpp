@@ -1,4 +1,47 @@
 #include "test.h"
 #include "milo/dtoa_milo.h"
+#include "double-conversion/bignum-dtoa.h"
 
 REGISTER_TEST(milo);
+
+void dtoa_milo_json(double value, char* buffer) {
+	dtoa_milo<JsonFormat>(value, buffer);
+}
+
+void dtoa_milo_scientific(double value, char* buffer) {
+	dtoa_milo<ScientificFormat>(value, buffer);
+}
+
+void dtoa_milo_printf(double value, char* buffer) {
+	dtoa_milo<PrintfGFormat>(value, buffer);
+}
+
+REGISTER_TEST(milo_json);
+REGISTER_TEST(milo_scientific);
+REGISTER_TEST(milo_printf);
+
+// Counted Grisu digits written by WriteExponent(); the few values it cannot
+// round with certainty take double-conversion's exact bignum path.
+void exponential_milo(double value, int digits, char* buffer) {
+	if (dtoa_milo_exponential<PrintfEFormat>(value, digits, buffer))
+		return;
+
+	using namespace double_conversion;
+	if (value < 0) {
+		*buffer++ = '-';
+		value = -value;
+	}
+	int length, point;
+	BignumDtoa(value, BIGNUM_DTOA_PRECISION, digits, Vector<char>(buffer, 18), &length, &point);
+	for (; length < digits; length++)
+		buffer[length] = '0';
+	Prettify<PrintfEFormat>(buffer, length, point - length);
+}
+
+REGISTER_EXPONENTIAL_TEST(milo);
+
+void ftoa_milo(float value, char* buffer) {
+	dtoa_milo(value, buffer);
+}
+
+REGISTER_FLOAT_TEST(milo);
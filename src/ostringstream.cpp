@@ -11,3 +11,59 @@ void dtoa_ostringstream(double value, char* buffer) {
 //#if RUN_CPPDTOA
 REGISTER_TEST(ostringstream);
 //#endif
+
+#if __cplusplus >= 201103L
+
+// Reuses one stream per thread, so the stream and its locale are constructed
+// once; str("") resets the contents but keeps the string's capacity.
+void dtoa_ostringstream_reuse(double value, char* buffer) {
+	thread_local std::ostringstream oss;
+	thread_local bool initialized = false;
+	if (!initialized) {
+		oss << std::setprecision(17);
+		initialized = true;
+	}
+	oss.str("");
+	oss << value;
+#if __cplusplus > 201703L
+	// view() reads the contents without copying them into a new string.
+	std::string_view s = oss.view();
+#else
+	std::string s = oss.str();
+#endif
+	memcpy(buffer, s.data(), s.size());
+	buffer[s.size()] = '\0';
+}
+
+// Stream buffer writing directly into the caller's buffer.
+class ArrayStreambuf : public std::streambuf {
+public:
+	void Reset(char* buffer, size_t size) {
+		setp(buffer, buffer + size);
+	}
+
+	char* Cursor() const {
+		return pptr();
+	}
+};
+
+// Formats through a per-thread ostream over ArrayStreambuf: no string, no
+// copy and no heap allocation per call.
+void dtoa_ostringstream_streambuf(double value, char* buffer) {
+	thread_local ArrayStreambuf streambuf;
+	thread_local std::ostream os(&streambuf);
+	thread_local bool initialized = false;
+	if (!initialized) {
+		os << std::setprecision(17);
+		initialized = true;
+	}
+	streambuf.Reset(buffer, 24);	// leaves room for the terminating null
+	os.clear();
+	os << value;
+	*streambuf.Cursor() = '\0';
+}
+
+REGISTER_TEST(ostringstream_reuse);
+REGISTER_TEST(ostringstream_streambuf);
+
+#endif
@@ -0,0 +1,192 @@
+#pragma once
+
+// Producer/consumer pipeline for streaming formatted output.
+// Worker threads fill fixed-size buffers and a writer thread drains them, so
+// formatting overlaps with I/O. Buffers circulate between two lock-free rings
+// of buffer descriptors: free buffers go writer -> workers, filled buffers go
+// workers -> writer. With a fixed number of buffers, workers wait for the
+// writer when it falls behind (backpressure).
+
+#if __cplusplus >= 201103L
+
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+// Bounded lock-free ring (D. Vyukov's MPMC queue). Every cell carries a
+// sequence number telling producers and consumers whether it is theirs, so
+// any number of threads may push and pop; here it is used as MPSC (filled
+// buffers) and SPMC (free buffers).
+template <typename T>
+class BoundedRing {
+public:
+	// capacity must be a power of two.
+	explicit BoundedRing(size_t capacity) : mCells(capacity), mMask(capacity - 1), mEnqueuePos(0), mDequeuePos(0) {
+		for (size_t i = 0; i < capacity; i++)
+			mCells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	bool TryPush(const T& value) {
+		size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+		Cell* cell;
+		for (;;) {
+			cell = &mCells[pos & mMask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+			if (diff == 0) {
+				if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+				return false;	// full
+			else
+				pos = mEnqueuePos.load(std::memory_order_relaxed);
+		}
+		cell->value = value;
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool TryPop(T& value) {
+		size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+		Cell* cell;
+		for (;;) {
+			cell = &mCells[pos & mMask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+			if (diff == 0) {
+				if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+				return false;	// empty
+			else
+				pos = mDequeuePos.load(std::memory_order_relaxed);
+		}
+		value = cell->value;
+		cell->sequence.store(pos + mMask + 1, std::memory_order_release);
+		return true;
+	}
+
+	void Push(const T& value) {
+		while (!TryPush(value))
+			std::this_thread::yield();
+	}
+
+	void Pop(T& value) {
+		while (!TryPop(value))
+			std::this_thread::yield();
+	}
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	std::vector<Cell> mCells;
+	const size_t mMask;
+	// Keep producer and consumer positions on separate cache lines.
+	char mPad0[64];
+	std::atomic<size_t> mEnqueuePos;
+	char mPad1[64];
+	std::atomic<size_t> mDequeuePos;
+	char mPad2[64];
+};
+
+struct PipelineConfig {
+	PipelineConfig() : bufferSize(1 << 20), bufferCount(8), workerCount(2) {}
+
+	size_t bufferSize;	// bytes per buffer
+	size_t bufferCount;	// buffers in flight, bounds memory and queueing
+	unsigned workerCount;	// formatting threads, plus one writer thread
+};
+
+struct PipelineBuffer {
+	char* data;
+	size_t length;
+	size_t chunk;	// index of the chunk the buffer holds
+};
+
+// Produces chunkCount chunks. fill(context, chunk, buffer, capacity) formats
+// chunk into buffer and returns its length; it runs on the worker threads
+// concurrently. sink(context, buffer, length) runs on the writer thread.
+// workerExit(context), if given, runs on each worker thread after its last
+// chunk, to release per-thread state of the formatting code.
+// Chunks reach the sink in completion order, not chunk order; a sink that
+// needs the original order can use PipelineBuffer::chunk to reorder.
+class Pipeline {
+public:
+	typedef size_t (*FillFunc)(void* context, size_t chunk, char* buffer, size_t capacity);
+	typedef void (*SinkFunc)(void* context, const char* buffer, size_t length);
+	typedef void (*WorkerExitFunc)(void* context);
+
+	explicit Pipeline(const PipelineConfig& config) :
+		mConfig(config),
+		mStorage(config.bufferSize * config.bufferCount),
+		mFree(RingCapacity(config.bufferCount)),
+		mFilled(RingCapacity(config.bufferCount))
+	{
+		for (size_t i = 0; i < config.bufferCount; i++) {
+			PipelineBuffer buffer = { &mStorage[i * config.bufferSize], 0, 0 };
+			mFree.Push(buffer);
+		}
+	}
+
+	void Run(size_t chunkCount, FillFunc fill, SinkFunc sink, void* context, WorkerExitFunc workerExit = 0) {
+		mNextChunk.store(0, std::memory_order_relaxed);
+
+		std::vector<std::thread> workers;
+		for (unsigned i = 0; i < mConfig.workerCount; i++)
+			workers.push_back(std::thread(&Pipeline::Work, this, chunkCount, fill, workerExit, context));
+
+		std::thread writer(&Pipeline::Write, this, chunkCount, sink, context);
+
+		for (size_t i = 0; i < workers.size(); i++)
+			workers[i].join();
+		writer.join();
+	}
+
+private:
+	static size_t RingCapacity(size_t count) {
+		size_t capacity = 1;
+		while (capacity < count)
+			capacity <<= 1;
+		return capacity;
+	}
+
+	void Work(size_t chunkCount, FillFunc fill, WorkerExitFunc workerExit, void* context) {
+		for (;;) {
+			size_t chunk = mNextChunk.fetch_add(1, std::memory_order_relaxed);
+			if (chunk >= chunkCount) {
+				if (workerExit)
+					workerExit(context);
+				return;
+			}
+			PipelineBuffer buffer;
+			mFree.Pop(buffer);	// waits for the writer when all buffers are in flight
+			buffer.chunk = chunk;
+			buffer.length = fill(context, chunk, buffer.data, mConfig.bufferSize);
+			mFilled.Push(buffer);
+		}
+	}
+
+	void Write(size_t chunkCount, SinkFunc sink, void* context) {
+		for (size_t i = 0; i < chunkCount; i++) {
+			PipelineBuffer buffer;
+			mFilled.Pop(buffer);
+			sink(context, buffer.data, buffer.length);
+			mFree.Push(buffer);
+		}
+	}
+
+	PipelineConfig mConfig;
+	std::vector<char> mStorage;
+	BoundedRing<PipelineBuffer> mFree;
+	BoundedRing<PipelineBuffer> mFilled;
+	std::atomic<size_t> mNextChunk;
+};
+
+#endif // __cplusplus >= 201103L
@@ -58,4 +58,10 @@
 #	define COMPILER "Unknown"
 #endif
 
+// Builds that set BUILD_VARIANT (the CMake build does) tag their results with
+// it, so results of differently optimized builds do not overwrite each other.
+#ifdef BUILD_VARIANT
+#define RESULT_FILENAME MACHINE "_" OS "_" COMPILER "_" BUILD_VARIANT ".csv"
+#else
 #define RESULT_FILENAME MACHINE "_" OS "_" COMPILER ".csv"
+#endif
@@ -1,8 +1,29 @@
 #include <cstdio>
+#include <cstdlib>
 #include "test.h"
 
 void dtoa_sprintf(double value, char* buffer) {
 	sprintf(buffer, "%.17g", value);
 }
 
+void ftoa_sprintf(float value, char* buffer) {
+	sprintf(buffer, "%.9g", value);
+}
+
+void fixed_sprintf(double value, int precision, char* buffer) {
+	sprintf(buffer, "%.*f", precision, value);
+}
+
+void exponential_sprintf(double value, int digits, char* buffer) {
+	sprintf(buffer, "%.*e", digits - 1, value);
+}
+
+double atod_strtod(const char* str) {
+	return strtod(str, 0);
+}
+
 REGISTER_TEST(sprintf);
+REGISTER_FLOAT_TEST(sprintf);
+REGISTER_ATOD_TEST(strtod);
+REGISTER_FIXED_TEST(sprintf);
+REGISTER_EXPONENTIAL_TEST(sprintf);
@@ -0,0 +1,21 @@
+#if __cplusplus >= 202002L
+#include <version>
+#endif
+
+#if __cpp_lib_format >= 201907L
+
+#include <format>
+#include "test.h"
+
+void dtoa_std_format(double value, char* buffer) {
+	*std::format_to_n(buffer, 32, "{}", value).out = '\0';
+}
+
+void ftoa_std_format(float value, char* buffer) {
+	*std::format_to_n(buffer, 32, "{}", value).out = '\0';
+}
+
+REGISTER_TEST(std_format);
+REGISTER_FLOAT_TEST(std_format);
+
+#endif
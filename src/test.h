@@ -3,38 +3,48 @@
 #include <vector>
 #include <string.h>
 
-struct Test;
-typedef std::vector<const Test *> TestList;
-class TestManager {
+template <typename T>
+class TestManagerT {
 public:
-	static TestManager& Instance() {
-		static TestManager singleton;
+	typedef std::vector<const T *> List;
+
+	static TestManagerT& Instance() {
+		static TestManagerT singleton;
 		return singleton;
 	}
 
-	void AddTest(const Test* test) {
+	void AddTest(const T* test) {
 		mTests.push_back(test);
 	}
 
-	const TestList& GetTests() const {
+	const List& GetTests() const {
 		return mTests;
 	}
 
-	TestList& GetTests() {
+	List& GetTests() {
 		return mTests;
 	}
 
 private:
-	TestList mTests;
+	List mTests;
 };
 
+struct Test;
+typedef TestManagerT<Test> TestManager;
+typedef TestManager::List TestList;
+
+// threadExit, if set, releases what the implementation keeps per thread. It
+// is called on every benchmark thread other than the main thread once its
+// conversions are done.
 struct Test {
 	Test(
 		const char* fname,
-		void (*dtoa)(double, char*))
+		void (*dtoa)(double, char*),
+		void (*threadExit)() = 0)
 		:
 		fname(fname),
-		dtoa(dtoa)
+		dtoa(dtoa),
+		threadExit(threadExit)
 	{
 		TestManager::Instance().AddTest(this);
 	}
@@ -45,8 +55,113 @@ struct Test {
 
 	const char* fname;
 	void (*dtoa)(double, char*);
+	void (*threadExit)();
+};
+
+// Single precision (float) implementations, benchmarked as a separate track.
+struct FloatTest;
+typedef TestManagerT<FloatTest> FloatTestManager;
+typedef FloatTestManager::List FloatTestList;
+
+struct FloatTest {
+	FloatTest(
+		const char* fname,
+		void (*ftoa)(float, char*))
+		:
+		fname(fname),
+		ftoa(ftoa)
+	{
+		FloatTestManager::Instance().AddTest(this);
+	}
+
+	bool operator<(const FloatTest& rhs) const {
+		return strcmp(fname, rhs.fname) < 0;
+	}
+
+	const char* fname;
+	void (*ftoa)(float, char*);
+};
+
+// String to double implementations, benchmarked in the reverse direction.
+struct AtodTest;
+typedef TestManagerT<AtodTest> AtodTestManager;
+typedef AtodTestManager::List AtodTestList;
+
+struct AtodTest {
+	AtodTest(
+		const char* fname,
+		double (*atod)(const char*))
+		:
+		fname(fname),
+		atod(atod)
+	{
+		AtodTestManager::Instance().AddTest(this);
+	}
+
+	bool operator<(const AtodTest& rhs) const {
+		return strcmp(fname, rhs.fname) < 0;
+	}
+
+	const char* fname;
+	double (*atod)(const char*);
+};
+
+// Fixed precision implementations, formatting like printf("%.*f", precision,
+// value): exactly precision digits after the point, no point for precision 0.
+struct FixedTest;
+typedef TestManagerT<FixedTest> FixedTestManager;
+typedef FixedTestManager::List FixedTestList;
+
+struct FixedTest {
+	FixedTest(
+		const char* fname,
+		void (*fixed)(double, int, char*))
+		:
+		fname(fname),
+		fixed(fixed)
+	{
+		FixedTestManager::Instance().AddTest(this);
+	}
+
+	bool operator<(const FixedTest& rhs) const {
+		return strcmp(fname, rhs.fname) < 0;
+	}
+
+	const char* fname;
+	void (*fixed)(double, int, char*);
+};
+
+// Exponential implementations, formatting like printf("%.*e", digits - 1,
+// value): digits significant digits, one before the point. The exponent may be
+// written in the implementation's own style (e+05, e+5, e5).
+struct ExponentialTest;
+typedef TestManagerT<ExponentialTest> ExponentialTestManager;
+typedef ExponentialTestManager::List ExponentialTestList;
+
+struct ExponentialTest {
+	ExponentialTest(
+		const char* fname,
+		void (*exponential)(double, int, char*))
+		:
+		fname(fname),
+		exponential(exponential)
+	{
+		ExponentialTestManager::Instance().AddTest(this);
+	}
+
+	bool operator<(const ExponentialTest& rhs) const {
+		return strcmp(fname, rhs.fname) < 0;
+	}
+
+	const char* fname;
+	void (*exponential)(double, int, char*);
 };
 
 
 #define STRINGIFY(x) #x
 #define REGISTER_TEST(f) static Test gRegister##f(STRINGIFY(f), dtoa##_##f)
+#define REGISTER_TEST_THREAD_EXIT(f, threadExit) static Test gRegister##f(STRINGIFY(f), dtoa##_##f, threadExit)
+#define REGISTER_FLOAT_TEST(f) static FloatTest gRegisterFloat##f(STRINGIFY(f), ftoa##_##f)
+#define REGISTER_ATOD_TEST(f) static AtodTest gRegisterAtod##f(STRINGIFY(f), atod##_##f)
+#define REGISTER_FIXED_TEST(f) static FixedTest gRegisterFixed##f(STRINGIFY(f), fixed##_##f)
+#define REGISTER_EXPONENTIAL_TEST(f) static ExponentialTest gRegisterExponential##f(STRINGIFY(f), exponential##_##f)
@@ -35,6 +35,36 @@ private:
 
 #else
 
+#include <time.h>
+
+#if defined(CLOCK_MONOTONIC)
+
+// Nanosecond resolution, fine enough to time single conversions.
+class Timer {
+public:
+	Timer() : start_(), end_() {
+	}
+
+	void Start() {
+		clock_gettime(CLOCK_MONOTONIC, &start_);
+	}
+
+	void Stop() {
+		clock_gettime(CLOCK_MONOTONIC, &end_);
+	}
+
+	double GetElapsedMilliseconds() {
+		return (end_.tv_sec - start_.tv_sec) * 1000.0
+			+ (end_.tv_nsec - start_.tv_nsec) / 1000000.0;
+	}
+
+private:
+	struct timespec start_;
+	struct timespec end_;
+};
+
+#else
+
 #include <sys/time.h>
 
 class Timer {
@@ -60,4 +90,6 @@ private:
   struct timeval end_;
 };
 
+#endif // CLOCK_MONOTONIC
+
 #endif
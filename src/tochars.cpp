@@ -0,0 +1,20 @@
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+
+#if __cpp_lib_to_chars >= 201611L
+
+#include "test.h"
+
+void dtoa_to_chars(double value, char* buffer) {
+	*std::to_chars(buffer, buffer + 32, value).ptr = '\0';
+}
+
+void ftoa_to_chars(float value, char* buffer) {
+	*std::to_chars(buffer, buffer + 32, value).ptr = '\0';
+}
+
+REGISTER_TEST(to_chars);
+REGISTER_FLOAT_TEST(to_chars);
+
+#endif
@@ -6,4 +6,27 @@ void dtoa_stb_sprintf(double value, char* buffer) {
 	stbsp_sprintf(buffer, "%.17g", value);
 }
 
+void dtoa_stb_sprintf_shortest(double value, char* buffer) {
+	stbsp_sprintf(buffer, "%r", value);
+}
+
+void ftoa_stb_sprintf(float value, char* buffer) {
+	stbsp_sprintf(buffer, "%.9g", value);
+}
+
+void fixed_stb_sprintf(double value, int precision, char* buffer) {
+	stbsp_sprintf(buffer, "%.*f", precision, value);
+}
+
+// Not exact: stb_sprintf generates at most 17 significant digits from an
+// approximate product, and can misround the 17th (-5.0000000000000004e-112
+// comes out as -5.0000000000000005e-112), so verification reports errors.
+void exponential_stb_sprintf(double value, int digits, char* buffer) {
+	stbsp_sprintf(buffer, "%.*e", digits - 1, value);
+}
+
 REGISTER_TEST(stb_sprintf);
+REGISTER_TEST(stb_sprintf_shortest);
+REGISTER_FLOAT_TEST(stb_sprintf);
+REGISTER_FIXED_TEST(stb_sprintf);
+REGISTER_EXPONENTIAL_TEST(stb_sprintf);
@@ -2,7 +2,7 @@
 // originally by Jeff Roberts / RAD Game Tools, 2015/10/20
 // http://github.com/nothings/stb
 //
-// allowed types:  sc uidBboXx p AaGgEef n
+// allowed types:  sc uidBboXx p AaGgEef Rr n
 // lengths      :  h ll j z t I64 I32 I
 //
 // Contributors (bugfixes):
@@ -83,6 +83,12 @@ with MSVC or GCC (but they don't match each other either).  We also
 don't attempt to find the minimum length matching float (pre-MSVC15 
 doesn't either).
 
+"%r" (and "%R") prints the shortest digits that round-trip, with the
+layout of "%.17g": stbsp_sprintf(buf, "%r", 0.1) gives "0.1" where "%.17g"
+gives "0.10000000000000001". The digits come from a Grisu2 core, which
+finds the shortest ones for more than 99.9% of values and round-trip
+digits for all of them. The precision is ignored.
+
 If you don't need float or doubles at all, define STB_SPRINTF_NOFLOAT
 and you'll save 4K of code space.
 
@@ -213,6 +219,7 @@ STBSP__PUBLICDEF void STB_SPRINTF_DECORATE( set_separators )( char comma, char p
 // internal float utility functions
 static stbsp__int32 stbsp__real_to_str( char const * * start, stbsp__uint32 * len, char *out, stbsp__int32 * decimal_pos, double value, stbsp__uint32 frac_digits );
 static stbsp__int32 stbsp__real_to_parts( stbsp__int64 * bits, stbsp__int32 * expo, double value );
+static stbsp__int32 stbsp__real_to_shortest( char const * * start, stbsp__uint32 * len, char *out, stbsp__int32 * decimal_pos, double value );
 #define STBSP__SPECIAL 0x7000
 #endif
 
@@ -432,6 +439,8 @@ STBSP__PUBLICDEF int STB_SPRINTF_DECORATE( vsprintfcb )( STBSP_SPRINTFCB * callb
       case 'a': // hex float
       case 'G': // float
       case 'g': // float
+      case 'R': // float
+      case 'r': // float
       case 'E': // float
       case 'e': // float
       case 'f': // float
@@ -517,6 +526,27 @@ STBSP__PUBLICDEF int STB_SPRINTF_DECORATE( vsprintfcb )( STBSP_SPRINTFCB * callb
         if(dp>0) { pr=(dp<(stbsp__int32)l)?l-dp:0; } else { pr = -dp+((pr>(stbsp__int32)l)?l:pr); }
         goto dofloatfromg;
 
+      case 'R': // float
+        h=hexu;
+        goto doshortest;
+
+      case 'r': // shortest round-trip float
+        h=hex;
+       doshortest:
+        fv = va_arg(va,double);
+        // read the shortest digits that round-trip, the precision is ignored
+        if ( stbsp__real_to_shortest( &sn, &l, num, &dp, fv ) )
+          fl |= STBSP__NEGATIVE;
+
+        // use %e where "%.17g" would, every digit is significant
+        if ((dp<=-4)||(dp>17))
+        {
+          pr = l-1;
+          goto doexpfromg;
+        }
+        if(dp>0) { pr=(dp<(stbsp__int32)l)?l-dp:0; } else { pr = -dp+l; }
+        goto dofloatfromg;
+
       case 'E': // float
         h=hexu;  
         goto doexp;
@@ -1141,6 +1171,195 @@ static stbsp__int32 stbsp__real_to_str( char const * * start, stbsp__uint32 * le
   return ng;
 }
 
+// Shortest round-trip digits for %r and %R, by Grisu2 (Florian Loitsch,
+// "Printing Floating-Point Numbers Quickly and Accurately with Integers",
+// PLDI 2010). The digits always read back to the same double, and they are
+// the shortest such digits for more than 99.9% of values.
+
+#define STBSP__U64(h,l) ((((stbsp__uint64)(h))<<32)|((stbsp__uint64)(l)))
+
+// normalized 64-bit significands and binary exponents of 10^-348, 10^-340, ..., 10^340
+static stbsp__uint64 const stbsp__grisu_pow10_f[87]={
+  STBSP__U64(0xfa8fd5a0,0x081c0288),STBSP__U64(0xbaaee17f,0xa23ebf76),STBSP__U64(0x8b16fb20,0x3055ac76),
+  STBSP__U64(0xcf42894a,0x5dce35ea),STBSP__U64(0x9a6bb0aa,0x55653b2d),STBSP__U64(0xe61acf03,0x3d1a45df),
+  STBSP__U64(0xab70fe17,0xc79ac6ca),STBSP__U64(0xff77b1fc,0xbebcdc4f),STBSP__U64(0xbe5691ef,0x416bd60c),
+  STBSP__U64(0x8dd01fad,0x907ffc3c),STBSP__U64(0xd3515c28,0x31559a83),STBSP__U64(0x9d71ac8f,0xada6c9b5),
+  STBSP__U64(0xea9c2277,0x23ee8bcb),STBSP__U64(0xaecc4991,0x4078536d),STBSP__U64(0x823c1279,0x5db6ce57),
+  STBSP__U64(0xc2109436,0x4dfb5637),STBSP__U64(0x9096ea6f,0x3848984f),STBSP__U64(0xd77485cb,0x25823ac7),
+  STBSP__U64(0xa086cfcd,0x97bf97f4),STBSP__U64(0xef340a98,0x172aace5),STBSP__U64(0xb23867fb,0x2a35b28e),
+  STBSP__U64(0x84c8d4df,0xd2c63f3b),STBSP__U64(0xc5dd4427,0x1ad3cdba),STBSP__U64(0x936b9fce,0xbb25c996),
+  STBSP__U64(0xdbac6c24,0x7d62a584),STBSP__U64(0xa3ab6658,0x0d5fdaf6),STBSP__U64(0xf3e2f893,0xdec3f126),
+  STBSP__U64(0xb5b5ada8,0xaaff80b8),STBSP__U64(0x87625f05,0x6c7c4a8b),STBSP__U64(0xc9bcff60,0x34c13053),
+  STBSP__U64(0x964e858c,0x91ba2655),STBSP__U64(0xdff97724,0x70297ebd),STBSP__U64(0xa6dfbd9f,0xb8e5b88f),
+  STBSP__U64(0xf8a95fcf,0x88747d94),STBSP__U64(0xb9447093,0x8fa89bcf),STBSP__U64(0x8a08f0f8,0xbf0f156b),
+  STBSP__U64(0xcdb02555,0x653131b6),STBSP__U64(0x993fe2c6,0xd07b7fac),STBSP__U64(0xe45c10c4,0x2a2b3b06),
+  STBSP__U64(0xaa242499,0x697392d3),STBSP__U64(0xfd87b5f2,0x8300ca0e),STBSP__U64(0xbce50864,0x92111aeb),
+  STBSP__U64(0x8cbccc09,0x6f5088cc),STBSP__U64(0xd1b71758,0xe219652c),STBSP__U64(0x9c400000,0x00000000),
+  STBSP__U64(0xe8d4a510,0x00000000),STBSP__U64(0xad78ebc5,0xac620000),STBSP__U64(0x813f3978,0xf8940984),
+  STBSP__U64(0xc097ce7b,0xc90715b3),STBSP__U64(0x8f7e32ce,0x7bea5c70),STBSP__U64(0xd5d238a4,0xabe98068),
+  STBSP__U64(0x9f4f2726,0x179a2245),STBSP__U64(0xed63a231,0xd4c4fb27),STBSP__U64(0xb0de6538,0x8cc8ada8),
+  STBSP__U64(0x83c7088e,0x1aab65db),STBSP__U64(0xc45d1df9,0x42711d9a),STBSP__U64(0x924d692c,0xa61be758),
+  STBSP__U64(0xda01ee64,0x1a708dea),STBSP__U64(0xa26da399,0x9aef774a),STBSP__U64(0xf209787b,0xb47d6b85),
+  STBSP__U64(0xb454e4a1,0x79dd1877),STBSP__U64(0x865b8692,0x5b9bc5c2),STBSP__U64(0xc83553c5,0xc8965d3d),
+  STBSP__U64(0x952ab45c,0xfa97a0b3),STBSP__U64(0xde469fbd,0x99a05fe3),STBSP__U64(0xa59bc234,0xdb398c25),
+  STBSP__U64(0xf6c69a72,0xa3989f5c),STBSP__U64(0xb7dcbf53,0x54e9bece),STBSP__U64(0x88fcf317,0xf22241e2),
+  STBSP__U64(0xcc20ce9b,0xd35c78a5),STBSP__U64(0x98165af3,0x7b2153df),STBSP__U64(0xe2a0b5dc,0x971f303a),
+  STBSP__U64(0xa8d9d153,0x5ce3b396),STBSP__U64(0xfb9b7cd9,0xa4a7443c),STBSP__U64(0xbb764c4c,0xa7a44410),
+  STBSP__U64(0x8bab8eef,0xb6409c1a),STBSP__U64(0xd01fef10,0xa657842c),STBSP__U64(0x9b10a4e5,0xe9913129),
+  STBSP__U64(0xe7109bfb,0xa19c0c9d),STBSP__U64(0xac2820d9,0x623bf429),STBSP__U64(0x80444b5e,0x7aa7cf85),
+  STBSP__U64(0xbf21e440,0x03acdd2d),STBSP__U64(0x8e679c2f,0x5e44ff8f),STBSP__U64(0xd433179d,0x9c8cb841),
+  STBSP__U64(0x9e19db92,0xb4e31ba9),STBSP__U64(0xeb96bf6e,0xbadf77d9),STBSP__U64(0xaf87023b,0x9bf0ee6b)
+};
+static short const stbsp__grisu_pow10_e[87]={
+  -1220,-1193,-1166,-1140,-1113,-1087,-1060,-1034,-1007,-980,-954,-927,-901,-874,-847,
+  -821,-794,-768,-741,-715,-688,-661,-635,-608,-582,-555,-529,-502,-475,-449,
+  -422,-396,-369,-343,-316,-289,-263,-236,-210,-183,-157,-130,-103,-77,-50,
+  -24,3,30,56,83,109,136,162,189,216,242,269,295,322,348,
+  375,402,428,455,481,508,534,561,588,614,641,667,694,720,747,
+  774,800,827,853,880,907,933,960,986,1013,1039,1066
+};
+
+// upper 64 bits of the 128-bit product, rounded
+static stbsp__uint64 stbsp__grisu_mul( stbsp__uint64 x, stbsp__uint64 y )
+{
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 p = (unsigned __int128)x * y;
+  return (stbsp__uint64)(p >> 64) + (((stbsp__uint64)p >> 63) & 1);
+#else
+  stbsp__uint64 a = x >> 32, b = x & 0xffffffff, c = y >> 32, d = y & 0xffffffff;
+  stbsp__uint64 ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+  stbsp__uint64 t = (bd >> 32) + (ad & 0xffffffff) + (bc & 0xffffffff) + (((stbsp__uint64)1) << 31);
+  return ac + (ad >> 32) + (bc >> 32) + (t >> 32);
+#endif
+}
+
+static stbsp__int32 stbsp__grisu_clz( stbsp__uint64 f )
+{
+#if defined(__GNUC__)
+  return __builtin_clzll(f);
+#else
+  stbsp__int32 s = 0;
+  while ( ( f & (((stbsp__uint64)1)<<63) ) == 0 ) { f <<= 1; ++s; }
+  return s;
+#endif
+}
+
+// moves the last digit down while the result stays inside the boundaries and gets closer to v
+static void stbsp__grisu_round( char * out, stbsp__uint32 len, stbsp__uint64 delta, stbsp__uint64 rest, stbsp__uint64 ten_kappa, stbsp__uint64 wp_w )
+{
+  while ( ( rest < wp_w ) && ( delta - rest >= ten_kappa ) && ( ( rest + ten_kappa < wp_w ) || ( wp_w - rest > rest + ten_kappa - wp_w ) ) )
+  {
+    --out[len-1];
+    rest += ten_kappa;
+  }
+}
+
+// same interface as stbsp__real_to_str, with the digits written forward from out
+static stbsp__int32 stbsp__real_to_shortest( char const * * start, stbsp__uint32 * len, char *out, stbsp__int32 * decimal_pos, double value )
+{
+  double d;
+  stbsp__int64 bits = 0;
+  stbsp__uint64 f, w, mp, mm, one, delta, wp_w, p2;
+  stbsp__uint32 p1, n;
+  stbsp__int32 expo, ng, e, ep, em, s, k, kappa, idx, shift;
+  double dk;
+
+  d = value;
+  STBSP__COPYFP(bits,d);
+  expo = (stbsp__int32) ((bits >> 52) & 2047);
+  ng = (stbsp__int32)(bits >> 63);
+  f = bits & ((((stbsp__uint64)1)<<52)-1);
+
+  if ( expo == 2047 ) // is nan or inf?
+  {
+    *start = f ? "NaN" : "Inf";
+    *decimal_pos = STBSP__SPECIAL;
+    *len = 3;
+    return ng;
+  }
+
+  if ( expo == 0 )
+  {
+    if ( f == 0 ) // do zero
+    {
+      *decimal_pos = 1;
+      *start = out;
+      out[0] = '0'; *len = 1;
+      return ng;
+    }
+    e = 1 - 1075;
+  }
+  else
+  {
+    f |= ((stbsp__uint64)1)<<52;
+    e = expo - 1075;
+  }
+
+  // boundaries halfway to the neighbours, the lower one is closer at a power of two
+  mp = (f<<1)+1; ep = e-1;
+  s = stbsp__grisu_clz( mp ); mp <<= s; ep -= s;
+  if ( ( f == (((stbsp__uint64)1)<<52) ) && ( expo > 1 ) ) { mm = (f<<2)-1; em = e-2; } else { mm = (f<<1)-1; em = e-1; }
+  mm <<= em - ep;
+  s = stbsp__grisu_clz( f ); w = f << s;
+
+  // scale by a cached power 10^-k so that the binary exponent lands in [-60,-32]
+  dk = (-61 - ep) * 0.30102999566398114 + 347;
+  idx = (stbsp__int32)dk; if ( dk - idx > 0.0 ) ++idx;
+  idx = (idx >> 3) + 1;
+  k = -(-348 + (idx << 3));
+  shift = -(ep + stbsp__grisu_pow10_e[idx] + 64);
+  w = stbsp__grisu_mul( w, stbsp__grisu_pow10_f[idx] );
+  mp = stbsp__grisu_mul( mp, stbsp__grisu_pow10_f[idx] ) - 1;
+  mm = stbsp__grisu_mul( mm, stbsp__grisu_pow10_f[idx] ) + 1;
+  delta = mp - mm;
+  wp_w = mp - w;
+
+  // generate digits of the upper boundary until the rest is inside the boundaries
+  one = ((stbsp__uint64)1) << shift;
+  p1 = (stbsp__uint32)( mp >> shift );
+  p2 = mp & ( one - 1 );
+  kappa = 1; while ( ( kappa < 10 ) && ( p1 >= stbsp__powten[kappa] ) ) ++kappa;
+  n = 0;
+  while ( kappa > 0 )
+  {
+    stbsp__uint64 rest;
+    stbsp__uint32 dg, pw = (stbsp__uint32)stbsp__powten[kappa-1];
+    dg = p1 / pw; p1 -= dg * pw;
+    if ( dg || n ) out[n++] = (char)('0' + dg);
+    --kappa;
+    rest = ( ((stbsp__uint64)p1) << shift ) + p2;
+    if ( rest <= delta )
+    {
+      k += kappa;
+      stbsp__grisu_round( out, n, delta, rest, stbsp__powten[kappa] << shift, wp_w );
+      goto done;
+    }
+  }
+  for(;;)
+  {
+    char dg;
+    p2 *= 10;
+    delta *= 10;
+    dg = (char)( p2 >> shift );
+    if ( dg || n ) out[n++] = (char)('0' + dg);
+    p2 &= one - 1;
+    --kappa;
+    if ( p2 < delta )
+    {
+      k += kappa;
+      stbsp__grisu_round( out, n, delta, p2, one, wp_w * stbsp__powten[-kappa] );
+      break;
+    }
+  }
+ done:
+  *decimal_pos = (stbsp__int32)n + k;
+  *start = out;
+  *len = n;
+  return ng;
+}
+
+#undef STBSP__U64
+
 #undef stbsp__ddmulthi
 #undef stbsp__ddrenorm
 #undef stbsp__ddmultlo